@@ -106,6 +106,10 @@ private:
   /// this to succeed.
   /// \pre \p Inst is a return instruction.
   bool translateReturn(const Instruction &Inst);
+
+  /// Materialize the constant \p C into \p VReg at the current insertion
+  /// point. Only integer constants are supported for now.
+  bool translateConstant(const Constant &C, unsigned VReg);
   /// @}
 
   // Builder for machine instruction a la IRBuilder.
@@ -121,7 +125,8 @@ private:
   // at the proper place. E.g., Entry block or dominator block
   // of each constant depending on how fancy we want to be.
   // * Clear the different maps.
-  void finalize();
+  // \return true if all the constants could be materialized.
+  bool finalize();
 
   /// Get the VReg that represents \p Val.
   /// If such VReg does not exist, it is created.
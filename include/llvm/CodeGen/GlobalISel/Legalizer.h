@@ -0,0 +1,50 @@
+//== llvm/CodeGen/GlobalISel/Legalizer.h - Legalizer -------------*- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+/// \file A pass to convert the target-illegal operations created by IR -> MIR
+/// translation into ones the target expects to be able to select, as
+/// described by the target's LegalizerInfo.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CODEGEN_GLOBALISEL_LEGALIZER_H
+#define LLVM_CODEGEN_GLOBALISEL_LEGALIZER_H
+
+#include "llvm/CodeGen/MachineFunctionPass.h"
+
+namespace llvm {
+
+class MachineInstr;
+class MachineRegisterInfo;
+
+class Legalizer : public MachineFunctionPass {
+public:
+  static char ID;
+
+private:
+  /// Rewrite the generic instruction \p MI so that it operates on
+  /// \p WideSize-bit values.
+  ///
+  /// \return true if \p MI could be widened.
+  bool widenScalar(MachineInstr &MI, unsigned WideSize,
+                   MachineRegisterInfo &MRI) const;
+
+public:
+  // Ctor, nothing fancy.
+  Legalizer();
+
+  const char *getPassName() const override {
+    return "Legalizer";
+  }
+
+  bool runOnMachineFunction(MachineFunction &MF) override;
+};
+} // End namespace llvm.
+
+#endif
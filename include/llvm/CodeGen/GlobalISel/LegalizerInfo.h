@@ -0,0 +1,85 @@
+//==-- llvm/CodeGen/GlobalISel/LegalizerInfo.h -------------------*- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// Interface for Targets to specify which operations they can successfully
+/// select and how the others should be expanded most efficiently.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_CODEGEN_GLOBALISEL_LEGALIZERINFO_H
+#define LLVM_CODEGEN_GLOBALISEL_LEGALIZERINFO_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+
+#include <cstdint>
+#include <utility>
+
+namespace llvm {
+class MachineInstr;
+class Type;
+
+/// Describe, for each generic opcode and scalar size, whether the target can
+/// select the operation directly or how it has to be rewritten first.
+///
+/// Sizes are given in bits. A size of 0 stands for an instruction whose type
+/// is not a scalar integer, like the label type of G_BR.
+class LegalizerInfo {
+public:
+  enum LegalizeAction : std::uint8_t {
+    /// The operation is expected to be selectable directly by the target, and
+    /// no transformation is necessary.
+    Legal,
+
+    /// The operation should be implemented in terms of a wider scalar
+    /// base-type. For example an i1 add could be implemented as an i8 add,
+    /// ignoring the high bits of the result.
+    WidenScalar,
+
+    /// This operation is completely unsupported on the target. A programming
+    /// error has occurred.
+    Unsupported,
+  };
+
+  LegalizerInfo() {}
+  virtual ~LegalizerInfo() {}
+
+  /// Record that \p Opcode operating on \p Size-bit values should be
+  /// handled via \p Action.
+  void setAction(unsigned Opcode, unsigned Size, LegalizeAction Action);
+
+  /// Determine what action should be taken to legalize \p Opcode operating
+  /// on \p Size-bit values.
+  ///
+  /// Sizes that have no explicit action are widened to the smallest larger
+  /// size that is Legal for \p Opcode, if any, and Unsupported otherwise.
+  ///
+  /// \returns a pair consisting of the action and, for WidenScalar, the size
+  /// the operation should be performed in.
+  std::pair<LegalizeAction, unsigned> getAction(unsigned Opcode,
+                                                unsigned Size) const;
+
+  /// Determine what action should be taken to legalize the generic
+  /// instruction \p MI, based on its opcode and type.
+  std::pair<LegalizeAction, unsigned> getAction(const MachineInstr &MI) const;
+
+  bool isLegal(const MachineInstr &MI) const;
+
+  /// \returns the size in bits \p Ty is keyed on.
+  static unsigned getTypeSize(const Type *Ty);
+
+private:
+  typedef SmallVector<std::pair<unsigned, LegalizeAction>, 4> SizeActionList;
+
+  /// For each opcode, the actions recorded by setAction.
+  DenseMap<unsigned, SizeActionList> Actions;
+};
+
+} // End namespace llvm.
+
+#endif
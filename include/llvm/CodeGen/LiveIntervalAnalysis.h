@@ -29,6 +29,7 @@
 #include "llvm/CodeGen/SlotIndexes.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Recycler.h"
 #include "llvm/Target/TargetRegisterInfo.h"
 #include <cmath>
 
@@ -63,6 +64,13 @@ extern cl::opt<bool> UseSegmentSetForPhysRegs;
     ///
     VNInfo::Allocator VNInfoAllocator;
 
+    /// Pool for the LiveInterval objects, so that an interval and its inline
+    /// segments sit next to the other intervals of the function instead of
+    /// being scattered over the heap. Intervals removed while splitting are
+    /// recycled; the pool itself is released by releaseMemory().
+    BumpPtrAllocator IntervalAllocator;
+    Recycler<LiveInterval> IntervalRecycler;
+
     /// Live interval pointers for all the virtual registers.
     IndexedMap<LiveInterval*, VirtReg2IndexFunctor> VirtRegIntervals;
 
@@ -137,7 +145,7 @@ extern cl::opt<bool> UseSegmentSetForPhysRegs;
 
     // Interval removal.
     void removeInterval(unsigned Reg) {
-      delete VirtRegIntervals[Reg];
+      destroyInterval(VirtRegIntervals[Reg]);
       VirtRegIntervals[Reg] = nullptr;
     }
 
@@ -427,7 +435,8 @@ extern cl::opt<bool> UseSegmentSetForPhysRegs;
     bool computeDeadValues(LiveInterval &LI,
                            SmallVectorImpl<MachineInstr*> *dead);
 
-    static LiveInterval* createInterval(unsigned Reg);
+    LiveInterval* createInterval(unsigned Reg);
+    void destroyInterval(LiveInterval *LI);
 
     void printInstrs(raw_ostream &O) const;
     void dumpInstrs() const;
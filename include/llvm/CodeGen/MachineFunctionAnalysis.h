@@ -20,6 +20,7 @@ namespace llvm {
 
 class MachineFunction;
 class MachineFunctionInitializer;
+class MachineModuleInfo;
 class TargetMachine;
 
 /// MachineFunctionAnalysis - This class is a Pass that manages a
@@ -28,6 +29,7 @@ struct MachineFunctionAnalysis : public FunctionPass {
 private:
   const TargetMachine &TM;
   MachineFunction *MF;
+  MachineModuleInfo *MMI;
   unsigned NextFnNum;
   MachineFunctionInitializer *MFInitializer;
 
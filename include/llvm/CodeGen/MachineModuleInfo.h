@@ -186,6 +186,16 @@ class MachineModuleInfo : public ImmutablePass {
 
   EHPersonality PersonalityTypeCache;
 
+  /// RetainMachineFunctions - True if machine functions outlive the function
+  /// pass manager that created them, so that a module pass can see all of
+  /// them at once.
+  bool RetainMachineFunctions;
+
+  /// RetainedFunctions - Machine functions kept alive between function pass
+  /// managers, together with the per-function information above.
+  struct RetainedFunction;
+  DenseMap<const Function *, RetainedFunction *> RetainedFunctions;
+
 public:
   static char ID; // Pass identification, replacement for typeid
 
@@ -216,6 +226,27 @@ public:
   ///
   void EndFunction();
 
+  /// Keep machine functions alive after the function pass manager that
+  /// created them has finished with them. Used by module-level machine passes
+  /// such as the MachineOutliner.
+  void setRetainMachineFunctions(bool Retain) {
+    RetainMachineFunctions = Retain;
+  }
+  bool retainsMachineFunctions() const { return RetainMachineFunctions; }
+
+  /// Take ownership of \p MF along with the per-function information
+  /// collected for it so far, and reset that information for the next
+  /// function.
+  void retainMachineFunction(MachineFunction *MF);
+
+  /// Return the retained machine function for \p F, or null.
+  MachineFunction *getRetainedMachineFunction(const Function &F) const;
+
+  /// Give up ownership of the retained machine function for \p F and make
+  /// its per-function information current again. Returns null if \p F has
+  /// no retained machine function.
+  MachineFunction *takeRetainedMachineFunction(const Function &F);
+
   const MCContext &getContext() const { return Context; }
   MCContext &getContext() { return Context; }
 
@@ -374,6 +374,12 @@ namespace llvm {
   /// and propagates register usage information of callee to caller
   /// if available with PysicalRegisterUsageInfo pass.
   FunctionPass *createRegUsageInfoPropPass();
+
+  /// This pass replaces instruction sequences repeated across the module
+  /// with calls to new functions holding a single copy of each. It needs to
+  /// see every machine function at once, so the machine functions are kept
+  /// alive until it has run.
+  ModulePass *createMachineOutlinerPass();
 } // End llvm namespace
 
 /// Target machine pass initializer for passes with dependencies. Use with
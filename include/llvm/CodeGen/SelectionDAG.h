@@ -207,10 +207,20 @@ class SelectionDAG {
   /// CSE with existing nodes when a duplicate is requested.
   FoldingSet<SDNode> CSEMap;
 
-  /// Pool allocation for machine-opcode SDNode operands.
+  /// Pool allocation for machine-opcode SDNode operands. Operand arrays are
+  /// recycled as nodes are deallocated, so the pool is kept for the lifetime
+  /// of the SelectionDAG rather than being reset for every block.
   BumpPtrAllocator OperandAllocator;
   ArrayRecycler<SDUse> OperandRecycler;
 
+  /// Pool allocation for node data that cannot be recycled, such as shuffle
+  /// masks. Released by clear().
+  BumpPtrAllocator NodeDataAllocator;
+
+  /// Number of slabs owned by OperandAllocator and NodeDataAllocator after
+  /// the last clear().
+  size_t NumOperandSlabs = 0;
+
   /// Pool allocation for misc. objects that are created once per SelectionDAG.
   BumpPtrAllocator Allocator;
 
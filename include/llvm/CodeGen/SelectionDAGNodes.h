@@ -1227,8 +1227,8 @@ public:
 /// An index of -1 is treated as undef, such that the code generator may put
 /// any value in the corresponding element of the result.
 class ShuffleVectorSDNode : public SDNode {
-  // The memory for Mask is owned by the SelectionDAG's OperandAllocator, and
-  // is freed when the SelectionDAG object is destroyed.
+  // The memory for Mask is owned by the SelectionDAG's NodeDataAllocator, and
+  // is freed when the SelectionDAG is cleared or destroyed.
   const int *Mask;
 protected:
   friend class SelectionDAG;
@@ -1439,6 +1439,59 @@ public:
     return None;
   }
 
+  /// How the MachineOutliner treats an instruction.
+  enum MachineOutlinerInstrType {
+    /// The instruction may be outlined into any outlined function.
+    Legal,
+    /// The instruction may only be outlined into a function that is reached
+    /// by a jump rather than a call, i.e. one whose sequence ends in a
+    /// return. This covers instructions that depend on the position of the
+    /// stack pointer, and returns themselves.
+    LegalInTailCall,
+    /// The instruction must not be outlined; sequences never span it.
+    Illegal,
+    /// The instruction is ignored when looking for repeated sequences.
+    Invisible
+  };
+
+  /// Return true if the MachineOutliner may outline instructions from \p MF.
+  virtual bool isFunctionSafeToOutlineFrom(MachineFunction &MF) const {
+    return false;
+  }
+
+  /// Return how the MachineOutliner should treat \p MI.
+  virtual MachineOutlinerInstrType getOutliningType(MachineInstr &MI) const {
+    llvm_unreachable(
+        "Target didn't implement TargetInstrInfo::getOutliningType!");
+  }
+
+  /// Return the number of bytes saved by outlining \p Sequence, which occurs
+  /// \p Occurrences times, into a single function. \p IsTailCall is true if
+  /// the outlined function is reached by a jump and needs no return of its
+  /// own. Returns 0 if outlining does not pay off.
+  virtual unsigned getOutliningBenefit(ArrayRef<const MachineInstr *> Sequence,
+                                       unsigned Occurrences,
+                                       bool IsTailCall) const {
+    return 0;
+  }
+
+  /// Append the return sequence to the outlined function body \p MBB.
+  virtual void insertOutlinerEpilogue(MachineBasicBlock &MBB,
+                                      MachineFunction &MF,
+                                      bool IsTailCall) const {
+    llvm_unreachable(
+        "Target didn't implement TargetInstrInfo::insertOutlinerEpilogue!");
+  }
+
+  /// Insert a call (or, if \p IsTailCall, a jump) to the outlined function
+  /// \p MF before \p It, and return an iterator to the new instruction.
+  virtual MachineBasicBlock::iterator
+  insertOutlinedCall(MachineBasicBlock &MBB, MachineBasicBlock::iterator It,
+                     MachineFunction &MF, bool IsTailCall) const {
+    llvm_unreachable(
+        "Target didn't implement TargetInstrInfo::insertOutlinedCall!");
+  }
+
 private:
   unsigned CallFrameSetupOpcode, CallFrameDestroyOpcode;
   unsigned CatchRetOpcode;
@@ -25,6 +25,8 @@ namespace llvm {
 
 class CallLowering;
 class DataLayout;
+class InstructionSelector;
+class LegalizerInfo;
 class MachineFunction;
 class MachineInstr;
 class RegisterBankInfo;
@@ -88,6 +90,18 @@ public:
     return nullptr;
   }
   virtual const CallLowering *getCallLowering() const { return nullptr; }
+
+  /// If the target supports GlobalISel legalization, return the rules
+  /// describing which generic instructions are legal. Otherwise return
+  /// nullptr.
+  virtual const LegalizerInfo *getLegalizerInfo() const { return nullptr; }
+
+  /// If the target supports GlobalISel instruction selection, return the
+  /// selector for generic instructions. Otherwise return nullptr.
+  virtual const InstructionSelector *getInstructionSelector() const {
+    return nullptr;
+  }
+
   /// Target can subclass this hook to select a different DAG scheduler.
   virtual RegisterScheduler::FunctionPassCtor
       getDAGScheduler(CodeGenOpt::Level) const {
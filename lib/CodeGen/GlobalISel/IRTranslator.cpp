@@ -15,8 +15,9 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/CodeGen/GlobalISel/CallLowering.h"
 #include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
-#include "llvm/IR/Constant.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Value.h"
@@ -46,7 +47,9 @@ unsigned IRTranslator::getOrCreateVReg(const Value &Val) {
     unsigned Size = Val.getType()->getPrimitiveSizeInBits();
     unsigned VReg = MRI->createGenericVirtualRegister(Size);
     ValReg = VReg;
-    assert(!isa<Constant>(Val) && "Not yet implemented");
+    // Constants are materialized in finalize, once every use is known.
+    if (const Constant *CV = dyn_cast<Constant>(&Val))
+      Constants.insert(CV);
   }
   return ValReg;
 }
@@ -104,8 +107,14 @@ bool IRTranslator::translate(const Instruction &Inst) {
   switch(Inst.getOpcode()) {
   case Instruction::Add:
     return translateBinaryOp(TargetOpcode::G_ADD, Inst);
+  case Instruction::Sub:
+    return translateBinaryOp(TargetOpcode::G_SUB, Inst);
+  case Instruction::And:
+    return translateBinaryOp(TargetOpcode::G_AND, Inst);
   case Instruction::Or:
     return translateBinaryOp(TargetOpcode::G_OR, Inst);
+  case Instruction::Xor:
+    return translateBinaryOp(TargetOpcode::G_XOR, Inst);
   case Instruction::Br:
     return translateBr(Inst);
   case Instruction::Ret:
@@ -117,11 +126,40 @@ bool IRTranslator::translate(const Instruction &Inst) {
 }
 
 
-void IRTranslator::finalize() {
+bool IRTranslator::translateConstant(const Constant &C, unsigned VReg) {
+  const ConstantInt *CI = dyn_cast<ConstantInt>(&C);
+  if (!CI)
+    return false;
+  MachineInstr *MI = MIRBuilder.buildInstr(TargetOpcode::G_CONSTANT,
+                                           CI->getType());
+  MachineInstrBuilder(MIRBuilder.getMF(), MI)
+      .addReg(VReg, RegState::Define)
+      .addImm(CI->getSExtValue());
+  return true;
+}
+
+bool IRTranslator::finalize() {
+  // Materialize the constants at the beginning of the entry block, which
+  // dominates all their uses.
+  // FIXME: Sinking them closer to their users would shorten live ranges.
+  MachineBasicBlock &EntryBB = MIRBuilder.getMF().front();
+  MIRBuilder.setMBB(EntryBB, /* Beginning */ true);
+  MIRBuilder.setDebugLoc(DebugLoc());
+  bool Succeeded = true;
+  for (const Constant *C : Constants) {
+    if (!translateConstant(*C, ValToVReg[C])) {
+      DEBUG(dbgs() << "Cannot materialize: " << *C << '\n');
+      Succeeded = false;
+      break;
+    }
+  }
+
   // Release the memory used by the different maps we
   // needed during the translation.
   ValToVReg.clear();
   Constants.clear();
+  BBToMBB.clear();
+  return Succeeded;
 }
 
 bool IRTranslator::runOnMachineFunction(MachineFunction &MF) {
@@ -156,6 +194,9 @@ bool IRTranslator::runOnMachineFunction(MachineFunction &MF) {
     }
   }
 
+  if (!finalize())
+    report_fatal_error("Unable to materialize constant");
+
   // Now that the MachineFrameInfo has been configured, no further changes to
   // the reserved registers are possible.
   MRI->freezeReservedRegs(MF);
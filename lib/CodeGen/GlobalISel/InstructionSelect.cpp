@@ -0,0 +1,85 @@
+//===- llvm/CodeGen/GlobalISel/InstructionSelect.cpp - InstructionSelect ---==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the InstructionSelect class.
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/GlobalISel/InstructionSelect.h"
+
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/CodeGen/GlobalISel/InstructionSelector.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetRegisterInfo.h"
+#include "llvm/Target/TargetSubtargetInfo.h"
+
+#define DEBUG_TYPE "instruction-select"
+
+using namespace llvm;
+
+char InstructionSelect::ID = 0;
+INITIALIZE_PASS(InstructionSelect, DEBUG_TYPE,
+                "Select target instructions out of generic instructions",
+                false, false);
+
+InstructionSelect::InstructionSelect() : MachineFunctionPass(ID) {
+  initializeInstructionSelectPass(*PassRegistry::getPassRegistry());
+}
+
+static void reportSelectionError(const Twine &Msg, const MachineInstr *MI) {
+  std::string ErrStorage;
+  raw_string_ostream Err(ErrStorage);
+  Err << Msg;
+  if (MI)
+    Err << ": " << *MI;
+  report_fatal_error(Err.str());
+}
+
+bool InstructionSelect::runOnMachineFunction(MachineFunction &MF) {
+  DEBUG(dbgs() << "Selecting function: " << MF.getName() << '\n');
+  const InstructionSelector *ISel = MF.getSubtarget().getInstructionSelector();
+  assert(ISel && "Cannot work without InstructionSelector");
+
+  // Walk the blocks in post-order and their instructions bottom-up, so that
+  // the users of a value are selected before its definition. This lets the
+  // selector fold a definition into its users and drop it once it is dead.
+  for (MachineBasicBlock *MBB : post_order(&MF)) {
+    MachineBasicBlock::iterator MII = MBB->end();
+    while (MII != MBB->begin()) {
+      MachineInstr &MI = *--MII;
+      // The selector may erase MI and insert new instructions in its place:
+      // remember where to resume before handing MI over.
+      bool AtBegin = MII == MBB->begin();
+      MachineBasicBlock::iterator Prev = AtBegin ? MII : std::prev(MII);
+
+      DEBUG(dbgs() << "Selecting: " << MI);
+      if (!ISel->select(MI))
+        reportSelectionError("cannot select", &MI);
+
+      if (AtBegin)
+        break;
+      MII = std::next(Prev);
+    }
+  }
+
+  // Now that selection is complete, every virtual register that is still
+  // used must have been constrained to a register class.
+  MachineRegisterInfo &MRI = MF.getRegInfo();
+  for (unsigned I = 0, E = MRI.getNumVirtRegs(); I != E; ++I) {
+    unsigned Reg = TargetRegisterInfo::index2VirtReg(I);
+    if (!MRI.getRegClassOrNull(Reg) && !MRI.reg_nodbg_empty(Reg))
+      reportSelectionError("virtual register without a register class after "
+                           "selection",
+                           &*MRI.reg_instr_begin(Reg));
+  }
+
+  return true;
+}
@@ -0,0 +1,73 @@
+//===- llvm/CodeGen/GlobalISel/InstructionSelector.cpp -----------*- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the InstructionSelector class.
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/GlobalISel/InstructionSelector.h"
+
+#include "llvm/CodeGen/GlobalISel/RegisterBank.h"
+#include "llvm/CodeGen/GlobalISel/RegisterBankInfo.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetInstrInfo.h"
+#include "llvm/Target/TargetRegisterInfo.h"
+
+#define DEBUG_TYPE "instructionselector"
+
+using namespace llvm;
+
+bool InstructionSelector::constrainSelectedInstRegOperands(
+    MachineInstr &I, const TargetInstrInfo &TII, const TargetRegisterInfo &TRI,
+    const RegisterBankInfo &RBI) const {
+  MachineBasicBlock &MBB = *I.getParent();
+  MachineFunction &MF = *MBB.getParent();
+  MachineRegisterInfo &MRI = MF.getRegInfo();
+
+  for (unsigned OpI = 0, OpE = I.getNumExplicitOperands(); OpI != OpE; ++OpI) {
+    MachineOperand &MO = I.getOperand(OpI);
+    DEBUG(dbgs() << "Converting operand: " << MO << '\n');
+
+    if (!MO.isReg() || !MO.getReg() ||
+        TargetRegisterInfo::isPhysicalRegister(MO.getReg()))
+      continue;
+
+    const TargetRegisterClass *RC = TII.getRegClass(I.getDesc(), OpI, &TRI, MF);
+    assert(RC && "Selected inst should have regclass operand");
+
+    unsigned Reg = MO.getReg();
+    if (!MRI.getRegClassOrNull(Reg)) {
+      // A generic virtual register: its bank must be able to hold RC.
+      const RegisterBank *RegBank = MRI.getRegBankOrNull(Reg);
+      (void)RegBank;
+      assert((!RegBank || RegBank->covers(*RC)) &&
+             "Register bank does not cover the operand register class");
+      MRI.setRegClass(Reg, RC);
+      continue;
+    }
+
+    if (MRI.constrainRegClass(Reg, RC))
+      continue;
+
+    // The register already lives in an incompatible class. Go through a new
+    // register of the right class.
+    unsigned NewReg = MRI.createVirtualRegister(RC);
+    if (MO.isDef())
+      BuildMI(MBB, std::next(I.getIterator()), I.getDebugLoc(),
+              TII.get(TargetOpcode::COPY), Reg)
+          .addReg(NewReg);
+    else
+      BuildMI(MBB, I, I.getDebugLoc(), TII.get(TargetOpcode::COPY), NewReg)
+          .addReg(Reg);
+    MO.setReg(NewReg);
+  }
+  return true;
+}
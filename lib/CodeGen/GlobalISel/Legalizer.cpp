@@ -0,0 +1,103 @@
+//===-- llvm/CodeGen/GlobalISel/Legalizer.cpp - Legalizer --------*- C++ -*-==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the Legalizer class, which rewrites the generic
+/// instructions the target cannot select into ones it can.
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/GlobalISel/Legalizer.h"
+
+#include "llvm/CodeGen/GlobalISel/LegalizerInfo.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetOpcodes.h"
+#include "llvm/Target/TargetRegisterInfo.h"
+#include "llvm/Target/TargetSubtargetInfo.h"
+
+#define DEBUG_TYPE "legalizer"
+
+using namespace llvm;
+
+char Legalizer::ID = 0;
+INITIALIZE_PASS(Legalizer, "legalizer",
+                "Legalize the generic instructions of a function", false,
+                false);
+
+Legalizer::Legalizer() : MachineFunctionPass(ID) {
+  initializeLegalizerPass(*PassRegistry::getPassRegistry());
+}
+
+bool Legalizer::widenScalar(MachineInstr &MI, unsigned WideSize,
+                            MachineRegisterInfo &MRI) const {
+  switch (MI.getOpcode()) {
+  default:
+    return false;
+  case TargetOpcode::G_ADD:
+  case TargetOpcode::G_SUB:
+  case TargetOpcode::G_AND:
+  case TargetOpcode::G_OR:
+  case TargetOpcode::G_XOR:
+  case TargetOpcode::G_CONSTANT:
+    break;
+  }
+
+  // The low bits of the result of these operations only depend on the low
+  // bits of their operands. Thus they can be performed on the wider type in
+  // place: whatever ends up in the high bits is never observed by the users
+  // of the narrow value.
+  for (const MachineOperand &MO : MI.operands()) {
+    if (!MO.isReg() || !TargetRegisterInfo::isVirtualRegister(MO.getReg()))
+      continue;
+    if (MRI.getSize(MO.getReg()) < WideSize)
+      MRI.setSize(MO.getReg(), WideSize);
+  }
+  MI.setType(IntegerType::get(MI.getType()->getContext(), WideSize));
+  return true;
+}
+
+bool Legalizer::runOnMachineFunction(MachineFunction &MF) {
+  DEBUG(dbgs() << "Legalize Machine IR for: " << MF.getName() << '\n');
+  const LegalizerInfo *LegalInfo = MF.getSubtarget().getLegalizerInfo();
+  assert(LegalInfo && "Cannot legalize without LegalizerInfo");
+  MachineRegisterInfo &MRI = MF.getRegInfo();
+
+  bool Changed = false;
+  for (MachineBasicBlock &MBB : MF) {
+    for (MachineInstr &MI : MBB) {
+      if (!isPreISelGenericOpcode(MI.getOpcode()))
+        continue;
+
+      std::pair<LegalizerInfo::LegalizeAction, unsigned> Action =
+          LegalInfo->getAction(MI);
+      switch (Action.first) {
+      case LegalizerInfo::Legal:
+        continue;
+      case LegalizerInfo::WidenScalar:
+        if (widenScalar(MI, Action.second, MRI)) {
+          DEBUG(dbgs() << "Widened: " << MI);
+          Changed = true;
+          continue;
+        }
+        break;
+      case LegalizerInfo::Unsupported:
+        break;
+      }
+
+      std::string Msg;
+      raw_string_ostream OS(Msg);
+      OS << "unable to legalize instruction: ";
+      MI.print(OS);
+      report_fatal_error(OS.str());
+    }
+  }
+  return Changed;
+}
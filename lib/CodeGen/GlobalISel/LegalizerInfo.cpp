@@ -0,0 +1,70 @@
+//===---- lib/CodeGen/GlobalISel/LegalizerInfo.cpp - Legalizer -------------==//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Implement an interface to specify and query how an illegal operation on a
+// given type should be expanded.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/GlobalISel/LegalizerInfo.h"
+
+#include "llvm/CodeGen/MachineInstr.h"
+#include "llvm/IR/Type.h"
+#include "llvm/Target/TargetOpcodes.h"
+
+using namespace llvm;
+
+void LegalizerInfo::setAction(unsigned Opcode, unsigned Size,
+                              LegalizeAction Action) {
+  assert(isPreISelGenericOpcode(Opcode) && "Expected a generic opcode");
+  SizeActionList &List = Actions[Opcode];
+  for (auto &Entry : List) {
+    if (Entry.first == Size) {
+      Entry.second = Action;
+      return;
+    }
+  }
+  List.push_back(std::make_pair(Size, Action));
+}
+
+std::pair<LegalizerInfo::LegalizeAction, unsigned>
+LegalizerInfo::getAction(unsigned Opcode, unsigned Size) const {
+  auto It = Actions.find(Opcode);
+  if (It == Actions.end())
+    return std::make_pair(Unsupported, Size);
+
+  // Look for an explicit action, and remember the smallest legal size that
+  // could hold Size in case there is none.
+  unsigned WideSize = 0;
+  for (const auto &Entry : It->second) {
+    if (Entry.first == Size)
+      return std::make_pair(Entry.second, Size);
+    if (Entry.second == Legal && Size && Entry.first > Size &&
+        (!WideSize || Entry.first < WideSize))
+      WideSize = Entry.first;
+  }
+  if (WideSize)
+    return std::make_pair(WidenScalar, WideSize);
+  return std::make_pair(Unsupported, Size);
+}
+
+std::pair<LegalizerInfo::LegalizeAction, unsigned>
+LegalizerInfo::getAction(const MachineInstr &MI) const {
+  return getAction(MI.getOpcode(), getTypeSize(MI.getType()));
+}
+
+bool LegalizerInfo::isLegal(const MachineInstr &MI) const {
+  return getAction(MI).first == Legal;
+}
+
+unsigned LegalizerInfo::getTypeSize(const Type *Ty) {
+  if (!Ty || !Ty->isIntegerTy())
+    return 0;
+  return Ty->getIntegerBitWidth();
+}
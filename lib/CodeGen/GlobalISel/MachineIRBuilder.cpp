@@ -30,6 +30,7 @@ void MachineIRBuilder::setMF(MachineFunction &MF) {
 
 void MachineIRBuilder::setMBB(MachineBasicBlock &MBB, bool Beginning) {
   this->MBB = &MBB;
+  this->MI = nullptr;
   Before = Beginning;
   assert(&getMF() == MBB.getParent() &&
          "Basic block is in a different function");
@@ -89,12 +89,13 @@ LiveIntervals::LiveIntervals() : MachineFunctionPass(ID),
 
 LiveIntervals::~LiveIntervals() {
   delete LRCalc;
+  IntervalRecycler.clear(IntervalAllocator);
 }
 
 void LiveIntervals::releaseMemory() {
   // Free the live intervals themselves.
   for (unsigned i = 0, e = VirtRegIntervals.size(); i != e; ++i)
-    delete VirtRegIntervals[TargetRegisterInfo::index2VirtReg(i)];
+    destroyInterval(VirtRegIntervals[TargetRegisterInfo::index2VirtReg(i)]);
   VirtRegIntervals.clear();
   RegMaskSlots.clear();
   RegMaskBits.clear();
@@ -106,6 +107,11 @@ void LiveIntervals::releaseMemory() {
 
   // Release VNInfo memory regions, VNInfo objects don't need to be dtor'd.
   VNInfoAllocator.Reset();
+
+  // All intervals have been destroyed above; drop them from the recycler
+  // before handing the slabs back.
+  IntervalRecycler.clear(IntervalAllocator);
+  IntervalAllocator.Reset();
 }
 
 /// runOnMachineFunction - calculates LiveIntervals
@@ -180,7 +186,15 @@ void LiveIntervals::dumpInstrs() const {
 LiveInterval* LiveIntervals::createInterval(unsigned reg) {
   float Weight = TargetRegisterInfo::isPhysicalRegister(reg) ?
                   llvm::huge_valf : 0.0F;
-  return new LiveInterval(reg, Weight);
+  return new (IntervalRecycler.Allocate(IntervalAllocator))
+      LiveInterval(reg, Weight);
+}
+
+void LiveIntervals::destroyInterval(LiveInterval *LI) {
+  if (!LI)
+    return;
+  LI->~LiveInterval();
+  IntervalRecycler.Deallocate(IntervalAllocator, LI);
 }
 
 
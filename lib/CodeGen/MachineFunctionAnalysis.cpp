@@ -22,7 +22,8 @@ char MachineFunctionAnalysis::ID = 0;
 
 MachineFunctionAnalysis::MachineFunctionAnalysis(
     const TargetMachine &tm, MachineFunctionInitializer *MFInitializer)
-    : FunctionPass(ID), TM(tm), MF(nullptr), MFInitializer(MFInitializer) {
+    : FunctionPass(ID), TM(tm), MF(nullptr), MMI(nullptr),
+      MFInitializer(MFInitializer) {
   initializeMachineModuleInfoPass(*PassRegistry::getPassRegistry());
 }
 
@@ -47,14 +48,23 @@ bool MachineFunctionAnalysis::doInitialization(Module &M) {
 
 bool MachineFunctionAnalysis::runOnFunction(Function &F) {
   assert(!MF && "MachineFunctionAnalysis already initialized!");
-  MF = new MachineFunction(&F, TM, NextFnNum++,
-                           getAnalysis<MachineModuleInfo>());
+  MMI = &getAnalysis<MachineModuleInfo>();
+
+  // Pick up a machine function kept alive by an earlier function pass
+  // manager, or one created by a module-level machine pass.
+  if ((MF = MMI->takeRetainedMachineFunction(F)))
+    return false;
+
+  MF = new MachineFunction(&F, TM, NextFnNum++, *MMI);
   if (MFInitializer)
     MFInitializer->initializeMachineFunction(*MF);
   return false;
 }
 
 void MachineFunctionAnalysis::releaseMemory() {
-  delete MF;
+  if (MF && MMI && MMI->retainsMachineFunctions())
+    MMI->retainMachineFunction(MF);
+  else
+    delete MF;
   MF = nullptr;
 }
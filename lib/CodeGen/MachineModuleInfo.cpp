@@ -203,6 +203,69 @@ MachineModuleInfo::MachineModuleInfo()
 MachineModuleInfo::~MachineModuleInfo() {
 }
 
+/// The per-function part of MachineModuleInfo, saved while a machine function
+/// is retained between function pass managers.
+struct MachineModuleInfo::RetainedFunction {
+  std::unique_ptr<MachineFunction> MF;
+  std::vector<MCCFIInstruction> FrameInstructions;
+  std::vector<LandingPadInfo> LandingPads;
+  DenseMap<MCSymbol*, unsigned> CallSiteMap;
+  std::vector<const GlobalValue *> TypeInfos;
+  std::vector<unsigned> FilterIds;
+  std::vector<unsigned> FilterEnds;
+  bool CallsEHReturn;
+  bool CallsUnwindInit;
+  bool HasEHFunclets;
+  VariableDbgInfoMapTy VariableDbgInfos;
+};
+
+void MachineModuleInfo::retainMachineFunction(MachineFunction *MF) {
+  const Function *F = MF->getFunction();
+  assert(!RetainedFunctions.count(F) && "Machine function already retained");
+  RetainedFunction *RF = new RetainedFunction();
+  RF->MF.reset(MF);
+  RF->FrameInstructions = std::move(FrameInstructions);
+  RF->LandingPads = std::move(LandingPads);
+  RF->CallSiteMap = std::move(CallSiteMap);
+  RF->TypeInfos = std::move(TypeInfos);
+  RF->FilterIds = std::move(FilterIds);
+  RF->FilterEnds = std::move(FilterEnds);
+  RF->CallsEHReturn = CallsEHReturn;
+  RF->CallsUnwindInit = CallsUnwindInit;
+  RF->HasEHFunclets = HasEHFunclets;
+  RF->VariableDbgInfos = std::move(VariableDbgInfos);
+  RetainedFunctions[F] = RF;
+
+  EndFunction();
+}
+
+MachineFunction *
+MachineModuleInfo::getRetainedMachineFunction(const Function &F) const {
+  auto I = RetainedFunctions.find(&F);
+  return I == RetainedFunctions.end() ? nullptr : I->second->MF.get();
+}
+
+MachineFunction *
+MachineModuleInfo::takeRetainedMachineFunction(const Function &F) {
+  auto I = RetainedFunctions.find(&F);
+  if (I == RetainedFunctions.end())
+    return nullptr;
+  std::unique_ptr<RetainedFunction> RF(I->second);
+  RetainedFunctions.erase(I);
+
+  FrameInstructions = std::move(RF->FrameInstructions);
+  LandingPads = std::move(RF->LandingPads);
+  CallSiteMap = std::move(RF->CallSiteMap);
+  TypeInfos = std::move(RF->TypeInfos);
+  FilterIds = std::move(RF->FilterIds);
+  FilterEnds = std::move(RF->FilterEnds);
+  CallsEHReturn = RF->CallsEHReturn;
+  CallsUnwindInit = RF->CallsUnwindInit;
+  HasEHFunclets = RF->HasEHFunclets;
+  VariableDbgInfos = std::move(RF->VariableDbgInfos);
+  return RF->MF.release();
+}
+
 bool MachineModuleInfo::doInitialization(Module &M) {
 
   ObjFileMMI = nullptr;
@@ -214,12 +277,19 @@ bool MachineModuleInfo::doInitialization(Module &M) {
   PersonalityTypeCache = EHPersonality::Unknown;
   AddrLabelSymbols = nullptr;
   TheModule = nullptr;
+  RetainMachineFunctions = false;
 
   return false;
 }
 
 bool MachineModuleInfo::doFinalization(Module &M) {
 
+  // Machine functions still retained here were never handed back, e.g.
+  // because code generation stopped early.
+  for (auto &I : RetainedFunctions)
+    delete I.second;
+  RetainedFunctions.clear();
+
   Personalities.clear();
 
   delete AddrLabelSymbols;
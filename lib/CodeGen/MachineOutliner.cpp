@@ -0,0 +1,570 @@
+//===-- MachineOutliner.cpp - Outline repeated instruction sequences ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Replaces sequences of machine instructions that are repeated across the
+/// module with calls to new functions holding a single copy of each sequence.
+/// This trades a little speed for code size.
+///
+/// Every instruction of every machine function is mapped to an integer, with
+/// identical instructions getting the same integer. Instructions the target
+/// does not allow to be outlined, and block boundaries, get integers that
+/// occur nowhere else, so no repeated substring can span them. A suffix tree
+/// built over the resulting string gives the repeated substrings: each
+/// internal node of the tree is a substring that occurs once for every leaf
+/// below it. The target tells us how many bytes outlining each of them would
+/// save, and the most profitable non-overlapping ones are outlined.
+///
+/// A sequence ending in a return is outlined into a function that is jumped
+/// to rather than called, and returns straight to the original caller. Other
+/// sequences are called, so they must not depend on the stack pointer.
+///
+/// The pass runs once all machine functions have been code generated, so it
+/// asks MachineModuleInfo to keep them alive until it has run.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/Passes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetInstrInfo.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetRegisterInfo.h"
+#include "llvm/Target/TargetSubtargetInfo.h"
+#include <algorithm>
+#include <map>
+
+using namespace llvm;
+
+#define DEBUG_TYPE "machine-outliner"
+
+STATISTIC(NumOutlinedFunctions, "Number of functions created by outlining");
+STATISTIC(NumOutlinedSequences, "Number of sequences replaced by calls");
+STATISTIC(NumBytesSaved, "Estimated number of bytes saved by outlining");
+
+namespace {
+
+/// A suffix tree over a string of unsigned integers, built with Ukkonen's
+/// algorithm. The string must end in a character that occurs nowhere else,
+/// so that every suffix ends at a leaf.
+class SuffixTree {
+  struct Node {
+    /// The substring of the string labelling the edge into this node is
+    /// [Start, End]. Leaves end at the end of the string.
+    unsigned Start;
+    unsigned End;
+    bool IsLeaf;
+    /// For leaves, the start of the suffix they stand for.
+    unsigned SuffixIdx;
+    unsigned Link;
+    std::map<unsigned, unsigned> Children;
+  };
+
+  ArrayRef<unsigned> Str;
+  std::vector<Node> Nodes;
+  enum : unsigned { Root = 0 };
+
+  unsigned createNode(unsigned Start, unsigned End, bool IsLeaf,
+                      unsigned SuffixIdx) {
+    Nodes.push_back({Start, End, IsLeaf, SuffixIdx, Root, {}});
+    return Nodes.size() - 1;
+  }
+
+  unsigned edgeEnd(unsigned N) const {
+    return Nodes[N].IsLeaf ? Str.size() - 1 : Nodes[N].End;
+  }
+
+  unsigned edgeLength(unsigned N) const {
+    return edgeEnd(N) - Nodes[N].Start + 1;
+  }
+
+public:
+  /// A substring that occurs more than once: its length and the start of
+  /// every occurrence, in increasing order.
+  struct RepeatedSubstring {
+    unsigned Length;
+    std::vector<unsigned> Starts;
+  };
+
+  explicit SuffixTree(ArrayRef<unsigned> Str);
+
+  /// Collect every repeated substring of at least \p MinLength characters.
+  void getRepeatedSubstrings(unsigned MinLength,
+                             std::vector<RepeatedSubstring> &Result) const;
+};
+
+} // end anonymous namespace
+
+SuffixTree::SuffixTree(ArrayRef<unsigned> S) : Str(S) {
+  Nodes.reserve(2 * Str.size() + 1);
+  createNode(0, 0, false, 0);
+
+  unsigned ActiveNode = Root, ActiveEdge = 0, ActiveLength = 0;
+  unsigned Remaining = 0;
+  for (unsigned i = 0, e = Str.size(); i != e; ++i) {
+    ++Remaining;
+    unsigned LastInternal = Root;
+    while (Remaining > 0) {
+      if (ActiveLength == 0)
+        ActiveEdge = i;
+
+      auto Child = Nodes[ActiveNode].Children.find(Str[ActiveEdge]);
+      if (Child == Nodes[ActiveNode].Children.end()) {
+        // No edge starts with the next character: hang a new leaf here.
+        unsigned Leaf = createNode(i, 0, true, i - Remaining + 1);
+        Nodes[ActiveNode].Children[Str[i]] = Leaf;
+        if (LastInternal != Root) {
+          Nodes[LastInternal].Link = ActiveNode;
+          LastInternal = Root;
+        }
+      } else {
+        unsigned Next = Child->second;
+        unsigned Length = edgeLength(Next);
+        if (ActiveLength >= Length) {
+          // Walk down to the next node and try again from there.
+          ActiveEdge += Length;
+          ActiveLength -= Length;
+          ActiveNode = Next;
+          continue;
+        }
+
+        if (Str[Nodes[Next].Start + ActiveLength] == Str[i]) {
+          // The suffix is already in the tree; extend it implicitly.
+          if (LastInternal != Root && ActiveNode != Root) {
+            Nodes[LastInternal].Link = ActiveNode;
+            LastInternal = Root;
+          }
+          ++ActiveLength;
+          break;
+        }
+
+        // Split the edge and hang a new leaf off the split point.
+        unsigned Split = createNode(Nodes[Next].Start,
+                                    Nodes[Next].Start + ActiveLength - 1,
+                                    false, 0);
+        Nodes[ActiveNode].Children[Str[ActiveEdge]] = Split;
+        unsigned Leaf = createNode(i, 0, true, i - Remaining + 1);
+        Nodes[Split].Children[Str[i]] = Leaf;
+        Nodes[Next].Start += ActiveLength;
+        Nodes[Split].Children[Str[Nodes[Next].Start]] = Next;
+        if (LastInternal != Root)
+          Nodes[LastInternal].Link = Split;
+        LastInternal = Split;
+      }
+
+      --Remaining;
+      if (ActiveNode == Root && ActiveLength > 0) {
+        --ActiveLength;
+        ActiveEdge = i - Remaining + 1;
+      } else if (ActiveNode != Root) {
+        ActiveNode = Nodes[ActiveNode].Link;
+      }
+    }
+  }
+}
+
+void SuffixTree::getRepeatedSubstrings(
+    unsigned MinLength, std::vector<RepeatedSubstring> &Result) const {
+  // Number the leaves in depth-first order, so that the leaves below each
+  // internal node form a contiguous range [FirstLeaf[N], LastLeaf[N]).
+  std::vector<unsigned> LeafStarts;
+  std::vector<unsigned> Depth(Nodes.size(), 0);
+  std::vector<unsigned> FirstLeaf(Nodes.size(), 0);
+  std::vector<unsigned> LastLeaf(Nodes.size(), 0);
+
+  // The tree can be as deep as the string is long, so walk it with an
+  // explicit stack. The second element is false on the way down.
+  SmallVector<std::pair<unsigned, bool>, 32> Worklist;
+  Worklist.push_back({Root, false});
+  while (!Worklist.empty()) {
+    unsigned N = Worklist.back().first;
+    if (Worklist.back().second) {
+      Worklist.pop_back();
+      LastLeaf[N] = LeafStarts.size();
+      continue;
+    }
+    Worklist.back().second = true;
+    FirstLeaf[N] = LeafStarts.size();
+    if (Nodes[N].IsLeaf) {
+      LeafStarts.push_back(Nodes[N].SuffixIdx);
+      continue;
+    }
+    // Push the children in reverse so they are visited in order.
+    for (auto I = Nodes[N].Children.rbegin(), E = Nodes[N].Children.rend();
+         I != E; ++I) {
+      Depth[I->second] = Depth[N] + edgeLength(I->second);
+      Worklist.push_back({I->second, false});
+    }
+  }
+
+  for (unsigned N = 1, e = Nodes.size(); N != e; ++N) {
+    if (Nodes[N].IsLeaf || Depth[N] < MinLength)
+      continue;
+    RepeatedSubstring RS;
+    RS.Length = Depth[N];
+    RS.Starts.assign(LeafStarts.begin() + FirstLeaf[N],
+                     LeafStarts.begin() + LastLeaf[N]);
+    std::sort(RS.Starts.begin(), RS.Starts.end());
+    Result.push_back(std::move(RS));
+  }
+}
+
+namespace {
+
+/// A sequence chosen for outlining.
+struct OutlinedFunction {
+  unsigned Length;
+  std::vector<unsigned> Starts;
+  bool IsTailCall;
+  unsigned Benefit;
+  MachineFunction *MF;
+};
+
+class MachineOutliner : public ModulePass {
+public:
+  static char ID;
+
+  MachineOutliner() : ModulePass(ID) {
+    initializeMachineOutlinerPass(*PassRegistry::getPassRegistry());
+  }
+
+  const char *getPassName() const override { return "Machine Outliner"; }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override {
+    AU.addRequired<MachineModuleInfo>();
+    AU.addPreserved<MachineModuleInfo>();
+    ModulePass::getAnalysisUsage(AU);
+  }
+
+  bool doInitialization(Module &M) override;
+  bool runOnModule(Module &M) override;
+
+private:
+  MachineModuleInfo *MMI;
+  const TargetMachine *TM;
+  unsigned NextOutlinedNum;
+
+  /// The instruction string, and the instruction each character stands for.
+  /// Characters that stand for no instruction map to an end() iterator.
+  std::vector<unsigned> Str;
+  std::vector<MachineBasicBlock::iterator> InstrList;
+
+  /// Characters given to legal instructions count up from 0; unique
+  /// characters for illegal instructions and block ends count down.
+  DenseMap<MachineInstr *, unsigned, MachineInstrExpressionTrait> InstrIDs;
+  unsigned NextLegalID;
+  unsigned NextUniqueID;
+
+  void mapFunction(MachineFunction &MF, const TargetInstrInfo &TII);
+  void appendUnique(MachineBasicBlock &MBB);
+
+  void findCandidates(const TargetInstrInfo &TII,
+                      std::vector<OutlinedFunction> &Candidates);
+  MachineFunction *createOutlinedFunction(Module &M, OutlinedFunction &OF,
+                                          unsigned FnNum);
+  void replaceOccurrence(OutlinedFunction &OF, unsigned Start);
+};
+
+} // end anonymous namespace
+
+char MachineOutliner::ID = 0;
+
+INITIALIZE_PASS(MachineOutliner, DEBUG_TYPE, "Machine Function Outliner",
+                false, false)
+
+ModulePass *llvm::createMachineOutlinerPass() { return new MachineOutliner(); }
+
+bool MachineOutliner::doInitialization(Module &M) {
+  MMI = getAnalysisIfAvailable<MachineModuleInfo>();
+  assert(MMI && "MachineOutliner requires MachineModuleInfo");
+  MMI->setRetainMachineFunctions(true);
+  return false;
+}
+
+void MachineOutliner::appendUnique(MachineBasicBlock &MBB) {
+  Str.push_back(NextUniqueID--);
+  InstrList.push_back(MBB.end());
+}
+
+void MachineOutliner::mapFunction(MachineFunction &MF,
+                                  const TargetInstrInfo &TII) {
+  for (MachineBasicBlock &MBB : MF) {
+    for (MachineBasicBlock::iterator I = MBB.begin(), E = MBB.end(); I != E;
+         ++I) {
+      switch (TII.getOutliningType(*I)) {
+      case TargetInstrInfo::Invisible:
+        continue;
+      case TargetInstrInfo::Illegal:
+        appendUnique(MBB);
+        continue;
+      case TargetInstrInfo::Legal:
+      case TargetInstrInfo::LegalInTailCall:
+        break;
+      }
+      auto Inserted = InstrIDs.insert({&*I, NextLegalID});
+      if (Inserted.second)
+        ++NextLegalID;
+      Str.push_back(Inserted.first->second);
+      InstrList.push_back(I);
+    }
+    // Sequences never continue into the next block.
+    appendUnique(MBB);
+  }
+}
+
+void MachineOutliner::findCandidates(
+    const TargetInstrInfo &TII, std::vector<OutlinedFunction> &Candidates) {
+  std::vector<SuffixTree::RepeatedSubstring> Repeats;
+  SuffixTree(Str).getRepeatedSubstrings(2, Repeats);
+
+  for (SuffixTree::RepeatedSubstring &RS : Repeats) {
+    // Occurrences of a periodic substring may overlap; keep the leftmost of
+    // each overlapping run.
+    std::vector<unsigned> Starts;
+    for (unsigned Start : RS.Starts)
+      if (Starts.empty() || Starts.back() + RS.Length <= Start)
+        Starts.push_back(Start);
+    if (Starts.size() < 2)
+      continue;
+
+    const MachineInstr &Last = *InstrList[Starts[0] + RS.Length - 1];
+    bool IsTailCall = Last.isReturn();
+    bool Legal = true;
+    SmallVector<const MachineInstr *, 8> Sequence;
+    for (unsigned i = Starts[0], e = i + RS.Length; i != e; ++i) {
+      MachineInstr &MI = *InstrList[i];
+      if (!IsTailCall &&
+          TII.getOutliningType(MI) == TargetInstrInfo::LegalInTailCall) {
+        Legal = false;
+        break;
+      }
+      Sequence.push_back(&MI);
+    }
+    if (!Legal)
+      continue;
+
+    unsigned Benefit =
+        TII.getOutliningBenefit(Sequence, Starts.size(), IsTailCall);
+    if (Benefit == 0)
+      continue;
+    Candidates.push_back(
+        {RS.Length, std::move(Starts), IsTailCall, Benefit, nullptr});
+  }
+
+  // Take the most profitable candidates first. Ties go to the longer one, so
+  // that a sequence is not cut up by its own pieces.
+  std::stable_sort(Candidates.begin(), Candidates.end(),
+                   [](const OutlinedFunction &A, const OutlinedFunction &B) {
+                     if (A.Benefit != B.Benefit)
+                       return A.Benefit > B.Benefit;
+                     return A.Length > B.Length;
+                   });
+
+  BitVector Used(Str.size());
+  std::vector<OutlinedFunction> Chosen;
+  for (OutlinedFunction &OF : Candidates) {
+    std::vector<unsigned> Starts;
+    for (unsigned Start : OF.Starts) {
+      int FirstUsed = Start ? Used.find_next(Start - 1) : Used.find_first();
+      if (FirstUsed == -1 || (unsigned)FirstUsed >= Start + OF.Length)
+        Starts.push_back(Start);
+    }
+    if (Starts.size() < 2)
+      continue;
+
+    // Recompute the benefit if some occurrences were taken by an earlier
+    // candidate.
+    if (Starts.size() != OF.Starts.size()) {
+      SmallVector<const MachineInstr *, 8> Sequence;
+      for (unsigned i = Starts[0], e = i + OF.Length; i != e; ++i)
+        Sequence.push_back(&*InstrList[i]);
+      OF.Benefit = TII.getOutliningBenefit(Sequence, Starts.size(),
+                                           OF.IsTailCall);
+      if (OF.Benefit == 0)
+        continue;
+    }
+
+    for (unsigned Start : Starts)
+      Used.set(Start, Start + OF.Length);
+    OF.Starts = std::move(Starts);
+    Chosen.push_back(std::move(OF));
+  }
+  Candidates = std::move(Chosen);
+}
+
+/// Add the physical registers \p MI reads before they are written within the
+/// sequence to \p LiveIns, and the ones it writes to \p Defs.
+static void collectRegisters(const MachineInstr &MI,
+                             const TargetRegisterInfo &TRI,
+                             SmallVectorImpl<unsigned> &LiveIns,
+                             SmallVectorImpl<unsigned> &Defs) {
+  auto Overlaps = [&](ArrayRef<unsigned> Regs, unsigned Reg) {
+    for (unsigned R : Regs)
+      if (TRI.regsOverlap(R, Reg))
+        return true;
+    return false;
+  };
+  for (const MachineOperand &MO : MI.operands())
+    if (MO.isReg() && MO.getReg() && MO.readsReg() && !MO.isUndef() &&
+        !Overlaps(Defs, MO.getReg()) && !Overlaps(LiveIns, MO.getReg()))
+      LiveIns.push_back(MO.getReg());
+  for (const MachineOperand &MO : MI.operands())
+    if (MO.isReg() && MO.getReg() && MO.isDef() &&
+        std::find(Defs.begin(), Defs.end(), MO.getReg()) == Defs.end())
+      Defs.push_back(MO.getReg());
+}
+
+MachineFunction *
+MachineOutliner::createOutlinedFunction(Module &M, OutlinedFunction &OF,
+                                        unsigned FnNum) {
+  // The IR function only gives the machine function a name and a home; its
+  // body is never looked at.
+  LLVMContext &Ctx = M.getContext();
+  Function *F = Function::Create(
+      FunctionType::get(Type::getVoidTy(Ctx), false),
+      GlobalValue::InternalLinkage,
+      "OUTLINED_FUNCTION_" + Twine(NextOutlinedNum++), &M);
+  F->addFnAttr(Attribute::OptimizeForSize);
+  F->addFnAttr(Attribute::MinSize);
+  F->addFnAttr(Attribute::NoUnwind);
+  ReturnInst::Create(Ctx, BasicBlock::Create(Ctx, "entry", F));
+
+  MachineFunction *MF = new MachineFunction(F, *TM, FnNum, *MMI);
+  MF->getProperties().clear(MachineFunctionProperties::Property::IsSSA);
+  MF->getProperties().set(
+      MachineFunctionProperties::Property::AllVRegsAllocated);
+  MF->getRegInfo().freezeReservedRegs(*MF);
+
+  const TargetSubtargetInfo &STI = MF->getSubtarget();
+  const TargetRegisterInfo &TRI = *STI.getRegisterInfo();
+  MachineBasicBlock *MBB = MF->CreateMachineBasicBlock();
+  MF->push_back(MBB);
+
+  SmallVector<unsigned, 8> LiveIns, Defs;
+  for (unsigned i = OF.Starts[0], e = i + OF.Length; i != e; ++i) {
+    MachineInstr *NewMI = MF->CloneMachineInstr(&*InstrList[i]);
+    // Memory operands may name the original function's stack slots, and
+    // debug locations its scopes.
+    NewMI->dropMemRefs();
+    NewMI->setDebugLoc(DebugLoc());
+    collectRegisters(*NewMI, TRI, LiveIns, Defs);
+    MBB->insert(MBB->end(), NewMI);
+  }
+  for (unsigned Reg : LiveIns)
+    if (!MF->getRegInfo().isReserved(Reg))
+      MBB->addLiveIn(Reg);
+
+  STI.getInstrInfo()->insertOutlinerEpilogue(*MBB, *MF, OF.IsTailCall);
+  return MF;
+}
+
+void MachineOutliner::replaceOccurrence(OutlinedFunction &OF, unsigned Start) {
+  MachineBasicBlock::iterator Begin = InstrList[Start];
+  MachineBasicBlock::iterator End = std::next(InstrList[Start + OF.Length - 1]);
+  MachineBasicBlock &MBB = *Begin->getParent();
+  MachineFunction &MF = *MBB.getParent();
+  const TargetSubtargetInfo &STI = MF.getSubtarget();
+  const TargetRegisterInfo &TRI = *STI.getRegisterInfo();
+
+  SmallVector<unsigned, 8> LiveIns, Defs;
+  for (MachineBasicBlock::iterator I = Begin; I != End; ++I)
+    collectRegisters(*I, TRI, LiveIns, Defs);
+
+  MachineBasicBlock::iterator Call =
+      STI.getInstrInfo()->insertOutlinedCall(MBB, Begin, *OF.MF, OF.IsTailCall);
+
+  // A called sequence leaves its results behind for the code after it; say
+  // so on the call so that liveness stays accurate.
+  if (!OF.IsTailCall) {
+    MachineInstrBuilder MIB(MF, &*Call);
+    for (unsigned Reg : LiveIns)
+      if (!Call->readsRegister(Reg, &TRI))
+        MIB.addReg(Reg, RegState::Implicit);
+    for (unsigned Reg : Defs)
+      if (!Call->modifiesRegister(Reg, &TRI))
+        MIB.addReg(Reg, RegState::ImplicitDefine);
+  }
+
+  // Invisible instructions inside the range go with it.
+  MBB.erase(Begin, End);
+}
+
+bool MachineOutliner::runOnModule(Module &M) {
+  // Later function pass managers no longer need the machine functions kept
+  // alive beyond their own use.
+  MMI->setRetainMachineFunctions(false);
+
+  Str.clear();
+  InstrList.clear();
+  InstrIDs.clear();
+  NextLegalID = 0;
+  NextUniqueID = UINT_MAX;
+  NextOutlinedNum = 0;
+
+  const TargetInstrInfo *TII = nullptr;
+  unsigned NextFnNum = 0;
+  for (Function &F : M) {
+    MachineFunction *MF = MMI->getRetainedMachineFunction(F);
+    if (!MF)
+      continue;
+    NextFnNum = std::max(NextFnNum, MF->getFunctionNumber() + 1);
+    const TargetInstrInfo *FnTII = MF->getSubtarget().getInstrInfo();
+    if (F.hasFnAttribute(Attribute::OptimizeNone) ||
+        !FnTII->isFunctionSafeToOutlineFrom(*MF))
+      continue;
+    TII = FnTII;
+    TM = &MF->getTarget();
+    mapFunction(*MF, *TII);
+  }
+  if (!TII)
+    return false;
+
+  // Terminate the string so that every suffix ends at a leaf.
+  Str.push_back(NextUniqueID--);
+  InstrList.push_back(MachineBasicBlock::iterator());
+
+  std::vector<OutlinedFunction> Functions;
+  findCandidates(*TII, Functions);
+  InstrIDs.clear();
+  if (Functions.empty())
+    return false;
+
+  // Build every outlined function before touching the originals; the first
+  // occurrence of each sequence is the one copied.
+  for (OutlinedFunction &OF : Functions) {
+    OF.MF = createOutlinedFunction(M, OF, NextFnNum++);
+    ++NumOutlinedFunctions;
+    NumBytesSaved += OF.Benefit;
+    DEBUG(dbgs() << "Outlining " << OF.Length << " instructions from "
+                 << OF.Starts.size() << " places into "
+                 << OF.MF->getName() << " (saves " << OF.Benefit
+                 << " bytes)\n");
+  }
+  for (OutlinedFunction &OF : Functions) {
+    for (unsigned Start : OF.Starts)
+      replaceOccurrence(OF, Start);
+    NumOutlinedSequences += OF.Starts.size();
+    MMI->retainMachineFunction(OF.MF);
+  }
+
+  Str.clear();
+  InstrList.clear();
+  return true;
+}
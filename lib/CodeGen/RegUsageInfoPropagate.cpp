@@ -106,6 +106,11 @@ bool RegUsageInfoPropagationPass::runOnMachineFunction(MachineFunction &MF) {
       DEBUG(dbgs() << MI << "\n");
 
       auto UpdateRegMask = [&](const Function *F) {
+        // The usage recorded for a callee describes the body compiled here.
+        // Unless that body is the one that runs after linking, the call has
+        // to keep the conservative mask of its calling convention.
+        if (!F || !F->hasExactDefinition())
+          return;
         const auto *RegMask = PRUI->getRegUsageInfo(F);
         if (!RegMask)
           return;
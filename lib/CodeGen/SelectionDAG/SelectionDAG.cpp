@@ -18,6 +18,7 @@
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Analysis/ValueTracking.h"
 #include "llvm/CodeGen/MachineBasicBlock.h"
@@ -53,6 +54,12 @@
 
 using namespace llvm;
 
+#define DEBUG_TYPE "selectiondag"
+
+STATISTIC(NumOperandSlabAllocs,
+          "Number of slabs allocated for DAG operands and shuffle masks");
+STATISTIC(NumCSEMapWipes, "Number of times the whole CSE map was wiped");
+
 /// makeVTList - Return an instance of the SDVTList struct initialized with the
 /// specified members.
 static SDVTList makeVTList(const EVT *VTs, unsigned NumVTs) {
@@ -978,10 +985,28 @@ SDNode *SelectionDAG::FindNodeOrInsertPos(const FoldingSetNodeID &ID,
 }
 
 void SelectionDAG::clear() {
+  // Empty the CSE map but keep its buckets for the next DAG. A previous large
+  // DAG may have grown the table far beyond what this one needs; unlinking
+  // the few nodes that are in it is then cheaper than wiping every bucket.
+  if (CSEMap.size() < CSEMap.capacity() / 8) {
+    for (SDNode &N : allnodes())
+      CSEMap.RemoveNode(&N);
+  } else {
+    CSEMap.clear();
+    ++NumCSEMapWipes;
+  }
+  assert(CSEMap.size() == 0 && "Node missing from AllNodes");
+
+  // Node and operand memory goes back to the recyclers and is reused by the
+  // next DAG, be it for another block or another function.
   allnodes_clear();
-  OperandRecycler.clear(OperandAllocator);
-  OperandAllocator.Reset();
-  CSEMap.clear();
+
+  size_t NumSlabs =
+      OperandAllocator.GetNumSlabs() + NodeDataAllocator.GetNumSlabs();
+  NumOperandSlabAllocs += NumSlabs - NumOperandSlabs;
+  NodeDataAllocator.Reset();
+  NumOperandSlabs =
+      OperandAllocator.GetNumSlabs() + NodeDataAllocator.GetNumSlabs();
 
   ExtendedValueTypeNodes.clear();
   ExternalSymbols.clear();
@@ -1627,8 +1652,8 @@ SDValue SelectionDAG::getVectorShuffle(EVT VT, const SDLoc &dl, SDValue N1,
 
   // Allocate the mask array for the node out of the BumpPtrAllocator, since
   // SDNode doesn't have access to it.  This memory will be "leaked" when
-  // the node is deallocated, but recovered when the NodeAllocator is released.
-  int *MaskAlloc = OperandAllocator.Allocate<int>(NElts);
+  // the node is deallocated, but recovered when the DAG is cleared.
+  int *MaskAlloc = NodeDataAllocator.Allocate<int>(NElts);
   std::copy(MaskVec.begin(), MaskVec.end(), MaskAlloc);
 
   auto *N = newSDNode<ShuffleVectorSDNode>(VT, dl.getIROrder(),
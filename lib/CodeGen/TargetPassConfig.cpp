@@ -21,6 +21,7 @@
 #include "llvm/Analysis/Passes.h"
 #include "llvm/Analysis/ScopedNoAliasAA.h"
 #include "llvm/Analysis/TypeBasedAliasAnalysis.h"
+#include "llvm/CodeGen/MachineFunctionAnalysis.h"
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/RegAllocRegistry.h"
 #include "llvm/CodeGen/RegisterUsageInfo.h"
@@ -82,6 +83,9 @@ static cl::opt<bool> EnableImplicitNullChecks(
     "enable-implicit-null-checks",
     cl::desc("Fold null checks into faulting memory operations"),
     cl::init(false));
+static cl::opt<bool> EnableMachineOutliner("enable-machine-outliner",
+    cl::Hidden, cl::desc("Outline instruction sequences repeated across "
+                         "machine functions"));
 static cl::opt<bool> PrintLSR("print-lsr-output", cl::Hidden,
     cl::desc("Print LLVM IR produced by the loop-reduce pass"));
 static cl::opt<bool> PrintISelInput("print-isel-input", cl::Hidden,
@@ -658,6 +662,15 @@ void TargetPassConfig::addMachinePasses() {
   addPass(&XRayInstrumentationID, false);
   addPass(&PatchableFunctionID, false);
 
+  if (EnableMachineOutliner) {
+    // The outliner sees the whole module at once. The function passes after
+    // it need their own MachineFunctionAnalysis to hand the machine functions
+    // back to them.
+    addPass(createMachineOutlinerPass(), false, false);
+    addPass(new MachineFunctionAnalysis(*TM, nullptr), false, false);
+    printAndVerify("After Machine Outliner");
+  }
+
   AddingMachinePasses = false;
 }
 
@@ -0,0 +1,535 @@
+//===-- TNTAsmParser.cpp - Parse TNT assembly to MCInst instructions ------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "TNT.h"
+#include "MCTargetDesc/TNTMCTargetDesc.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCExpr.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCParser/MCAsmLexer.h"
+#include "llvm/MC/MCParser/MCParsedAsmOperand.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/TargetRegistry.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "tnt-asm-parser"
+
+namespace {
+struct TNTOperand;
+
+/// Parses TNT assembly from a stream.
+class TNTAsmParser : public MCTargetAsmParser {
+  MCAsmParser &Parser;
+  const MCSubtargetInfo &STI;
+  const MCInstrInfo &MII;
+
+  bool MatchAndEmitInstruction(SMLoc IDLoc, unsigned &Opcode,
+                               OperandVector &Operands, MCStreamer &Out,
+                               uint64_t &ErrorInfo,
+                               bool MatchingInlineAsm) override;
+
+  bool ParseRegister(unsigned &RegNo, SMLoc &StartLoc, SMLoc &EndLoc) override;
+
+  bool ParseInstruction(ParseInstructionInfo &Info, StringRef Name,
+                        SMLoc NameLoc, OperandVector &Operands) override;
+
+  bool ParseDirective(AsmToken DirectiveID) override { return true; }
+
+  unsigned validateTargetOperandClass(MCParsedAsmOperand &Op,
+                                      unsigned Kind) override;
+
+  bool parseJumpTarget(OperandVector &Operands);
+
+  bool parseOperand(OperandVector &Operands);
+
+  // Converts the parsed operands of a post-increment instruction, whose
+  // written back register is not spelled out in the assembly string.
+  void cvtPostInc(MCInst &Inst, const OperandVector &Operands);
+
+  MCAsmParser &getParser() const { return Parser; }
+  MCAsmLexer &getLexer() const { return Parser.getLexer(); }
+
+  /// @name Auto-generated Matcher Functions
+  /// {
+
+#define GET_ASSEMBLER_HEADER
+#include "TNTGenAsmMatcher.inc"
+
+  /// }
+
+public:
+  TNTAsmParser(const MCSubtargetInfo &STI, MCAsmParser &Parser,
+               const MCInstrInfo &MII, const MCTargetOptions &Options)
+      : MCTargetAsmParser(Options, STI), Parser(Parser), STI(STI),
+        MII(MII) {
+    MCAsmParserExtension::Initialize(Parser);
+    MRI = getContext().getRegisterInfo();
+
+    setAvailableFeatures(ComputeAvailableFeatures(STI.getFeatureBits()));
+  }
+
+private:
+  const MCRegisterInfo *MRI;
+};
+
+/// A parsed TNT assembly operand.
+struct TNTOperand : public MCParsedAsmOperand {
+  enum KindTy {
+    k_Tok,
+    k_Reg,
+    k_Imm,
+    k_Mem
+  } Kind;
+
+  struct Memory {
+    unsigned Reg;
+    const MCExpr *Offset;
+  };
+
+  union {
+    StringRef Tok;
+    unsigned Reg;
+    const MCExpr *Imm;
+    Memory Mem;
+  };
+
+  SMLoc Start, End;
+
+public:
+  TNTOperand(StringRef Tok, SMLoc const &S)
+      : MCParsedAsmOperand(), Kind(k_Tok), Tok(Tok), Start(S), End(S) {}
+  TNTOperand(KindTy Kind, unsigned Reg, SMLoc const &S, SMLoc const &E)
+      : MCParsedAsmOperand(), Kind(Kind), Reg(Reg), Start(S), End(E) {}
+  TNTOperand(const MCExpr *Imm, SMLoc const &S, SMLoc const &E)
+      : MCParsedAsmOperand(), Kind(k_Imm), Imm(Imm), Start(S), End(E) {}
+  TNTOperand(unsigned Reg, const MCExpr *Expr, SMLoc const &S,
+             SMLoc const &E)
+      : MCParsedAsmOperand(), Kind(k_Mem), Start(S), End(E) {
+    Mem.Reg = Reg;
+    Mem.Offset = Expr;
+  }
+
+  static std::unique_ptr<TNTOperand> CreateToken(StringRef Str, SMLoc S) {
+    return make_unique<TNTOperand>(Str, S);
+  }
+
+  static std::unique_ptr<TNTOperand> CreateReg(unsigned RegNum, SMLoc S,
+                                               SMLoc E) {
+    return make_unique<TNTOperand>(k_Reg, RegNum, S, E);
+  }
+
+  static std::unique_ptr<TNTOperand> CreateImm(const MCExpr *Val, SMLoc S,
+                                               SMLoc E) {
+    return make_unique<TNTOperand>(Val, S, E);
+  }
+
+  static std::unique_ptr<TNTOperand> CreateMem(unsigned RegNum,
+                                               const MCExpr *Val, SMLoc S,
+                                               SMLoc E) {
+    return make_unique<TNTOperand>(RegNum, Val, S, E);
+  }
+
+  void addExprOperand(MCInst &Inst, const MCExpr *Expr) const {
+    // Add as immediate when possible.
+    if (!Expr)
+      Inst.addOperand(MCOperand::createImm(0));
+    else if (const MCConstantExpr *CE = dyn_cast<MCConstantExpr>(Expr))
+      Inst.addOperand(MCOperand::createImm(CE->getValue()));
+    else
+      Inst.addOperand(MCOperand::createExpr(Expr));
+  }
+
+  void addRegOperands(MCInst &Inst, unsigned N) const {
+    assert(Kind == k_Reg && "Unexpected operand kind");
+    assert(N == 1 && "Invalid number of operands!");
+
+    Inst.addOperand(MCOperand::createReg(Reg));
+  }
+
+  void addImmOperands(MCInst &Inst, unsigned N) const {
+    assert(Kind == k_Imm && "Unexpected operand kind");
+    assert(N == 1 && "Invalid number of operands!");
+
+    addExprOperand(Inst, Imm);
+  }
+
+  void addMemOperands(MCInst &Inst, unsigned N) const {
+    assert(Kind == k_Mem && "Unexpected operand kind");
+    assert(N == 2 && "Invalid number of operands");
+
+    Inst.addOperand(MCOperand::createReg(Mem.Reg));
+    addExprOperand(Inst, Mem.Offset);
+  }
+
+  bool isReg() const override { return Kind == k_Reg; }
+  bool isImm() const override { return Kind == k_Imm; }
+  bool isToken() const override { return Kind == k_Tok; }
+  bool isMem() const override { return Kind == k_Mem; }
+
+  // Values the constant generators can produce without an extension word.
+  bool isCGImm() const {
+    if (Kind != k_Imm)
+      return false;
+
+    int64_t Val;
+    if (!Imm->evaluateAsAbsolute(Val))
+      return false;
+
+    return Val == 0 || Val == 1 || Val == 2 || Val == 4 || Val == 8 ||
+           Val == -1;
+  }
+
+  StringRef getToken() const {
+    assert(Kind == k_Tok && "Invalid access!");
+    return Tok;
+  }
+
+  unsigned getReg() const override {
+    assert(Kind == k_Reg && "Invalid access!");
+    return Reg;
+  }
+
+  void setReg(unsigned RegNo) {
+    assert(Kind == k_Reg && "Invalid access!");
+    Reg = RegNo;
+  }
+
+  SMLoc getStartLoc() const override { return Start; }
+  SMLoc getEndLoc() const override { return End; }
+
+  void print(raw_ostream &O) const override {
+    switch (Kind) {
+    case k_Tok:
+      O << "Token " << Tok;
+      break;
+    case k_Reg:
+      O << "Register " << Reg;
+      break;
+    case k_Imm:
+      O << "Immediate " << *Imm;
+      break;
+    case k_Mem:
+      O << "Memory ";
+      O << *Mem.Offset << "(" << Mem.Reg << ")";
+      break;
+    }
+  }
+};
+} // end anonymous namespace
+
+bool TNTAsmParser::MatchAndEmitInstruction(SMLoc Loc, unsigned &Opcode,
+                                           OperandVector &Operands,
+                                           MCStreamer &Out,
+                                           uint64_t &ErrorInfo,
+                                           bool MatchingInlineAsm) {
+  MCInst Inst;
+  unsigned MatchResult =
+      MatchInstructionImpl(Operands, Inst, ErrorInfo, MatchingInlineAsm);
+
+  switch (MatchResult) {
+  case Match_Success:
+    Inst.setLoc(Loc);
+    Out.EmitInstruction(Inst, STI);
+    Opcode = Inst.getOpcode();
+    return false;
+  case Match_MnemonicFail:
+    return Error(Loc, "invalid instruction mnemonic");
+  case Match_MissingFeature:
+    return Error(Loc, "instruction requires a CPU feature not currently "
+                      "enabled");
+  case Match_InvalidOperand: {
+    SMLoc ErrorLoc = Loc;
+    if (ErrorInfo != ~0U) {
+      if (ErrorInfo >= Operands.size())
+        return Error(ErrorLoc, "too few operands for instruction");
+
+      ErrorLoc = ((TNTOperand &)*Operands[ErrorInfo]).getStartLoc();
+      if (ErrorLoc == SMLoc())
+        ErrorLoc = Loc;
+    }
+    return Error(ErrorLoc, "invalid operand for instruction");
+  }
+  default:
+    return true;
+  }
+}
+
+// The 8-bit registers share their names with the 16-bit ones, so the
+// TableGen'erated matcher cannot be used. Registers are always parsed as
+// 16-bit and narrowed in validateTargetOperandClass.
+static unsigned MatchRegisterName(StringRef Name) {
+  return StringSwitch<unsigned>(Name)
+      .Case("r0", TNT::PC)
+      .Case("r1", TNT::SP)
+      .Case("r2", TNT::SR)
+      .Case("r3", TNT::CG)
+      .Case("r4", TNT::FP)
+      .Case("r5", TNT::R5)
+      .Case("r6", TNT::R6)
+      .Case("r7", TNT::R7)
+      .Case("r8", TNT::R8)
+      .Case("r9", TNT::R9)
+      .Case("r10", TNT::R10)
+      .Case("r11", TNT::R11)
+      .Case("r12", TNT::R12)
+      .Case("r13", TNT::R13)
+      .Case("r14", TNT::R14)
+      .Case("r15", TNT::R15)
+      .Default(TNT::NoRegister);
+}
+
+bool TNTAsmParser::ParseRegister(unsigned &RegNo, SMLoc &StartLoc,
+                                 SMLoc &EndLoc) {
+  if (getLexer().getKind() == AsmToken::Identifier) {
+    auto Name = getLexer().getTok().getIdentifier().lower();
+    RegNo = StringSwitch<unsigned>(Name)
+                .Case("pc", TNT::PC)
+                .Case("sp", TNT::SP)
+                .Case("sr", TNT::SR)
+                .Case("cg", TNT::CG)
+                .Default(MatchRegisterName(Name));
+    if (RegNo == TNT::NoRegister)
+      return true;
+
+    AsmToken const &T = getParser().getTok();
+    StartLoc = T.getLoc();
+    EndLoc = T.getEndLoc();
+    getLexer().Lex(); // eat register token
+
+    return false;
+  }
+
+  return Error(StartLoc, "invalid register name");
+}
+
+// Returns the condition code of a conditional jump mnemonic, or -1.
+static int getJumpCondCode(StringRef Name) {
+  return StringSwitch<int>(Name.lower())
+      .Cases("jne", "jnz", TNTCC::COND_NE)
+      .Cases("jeq", "jz", TNTCC::COND_E)
+      .Cases("jlo", "jnc", TNTCC::COND_LO)
+      .Cases("jhs", "jc", TNTCC::COND_HS)
+      .Case("jn", TNTCC::COND_N)
+      .Case("jge", TNTCC::COND_GE)
+      .Case("jl", TNTCC::COND_L)
+      .Default(-1);
+}
+
+bool TNTAsmParser::parseJumpTarget(OperandVector &Operands) {
+  const MCExpr *Val;
+  SMLoc StartLoc = getLexer().getLoc();
+  if (getParser().parseExpression(Val))
+    return Error(StartLoc, "expected expression operand");
+
+  SMLoc EndLoc = getLexer().getLoc();
+  Operands.push_back(TNTOperand::CreateImm(Val, StartLoc, EndLoc));
+  return false;
+}
+
+static void applyMnemonicAliases(StringRef &Mnemonic, uint64_t Features,
+                                 unsigned VariantID);
+
+bool TNTAsmParser::ParseInstruction(ParseInstructionInfo &Info,
+                                    StringRef Name, SMLoc NameLoc,
+                                    OperandVector &Operands) {
+  // Map mnemonics without a .b/.w suffix onto the word forms.
+  applyMnemonicAliases(Name, getAvailableFeatures(), 0);
+
+  bool Failed;
+  int CondCode = getJumpCondCode(Name);
+  if (CondCode >= 0) {
+    // Conditional jumps share one instruction with the condition as an
+    // operand.
+    Operands.push_back(TNTOperand::CreateToken("j", NameLoc));
+    const MCExpr *CC = MCConstantExpr::create(CondCode, getContext());
+    Operands.push_back(TNTOperand::CreateImm(CC, NameLoc, NameLoc));
+    Failed = parseJumpTarget(Operands);
+  } else if (Name.equals_lower("jmp")) {
+    Operands.push_back(TNTOperand::CreateToken(Name, NameLoc));
+    Failed = parseJumpTarget(Operands);
+  } else {
+    // First operand is instruction mnemonic
+    Operands.push_back(TNTOperand::CreateToken(Name, NameLoc));
+
+    // Parse first operand if any
+    Failed = getLexer().isNot(AsmToken::EndOfStatement) &&
+             parseOperand(Operands);
+
+    // Parse second operand if any
+    if (!Failed && getLexer().is(AsmToken::Comma)) {
+      getLexer().Lex(); // Eat ','
+      Failed = parseOperand(Operands);
+    }
+  }
+
+  if (Failed) {
+    getParser().eatToEndOfStatement();
+    return true;
+  }
+
+  if (getLexer().isNot(AsmToken::EndOfStatement)) {
+    SMLoc Loc = getLexer().getLoc();
+    getParser().eatToEndOfStatement();
+    return Error(Loc, "unexpected token");
+  }
+
+  getParser().Lex(); // Consume the EndOfStatement.
+  return false;
+}
+
+bool TNTAsmParser::parseOperand(OperandVector &Operands) {
+  switch (getLexer().getKind()) {
+  default:
+    return Error(getLexer().getLoc(), "unexpected token in operand");
+  case AsmToken::Identifier: {
+    // try rN
+    unsigned RegNo;
+    SMLoc StartLoc, EndLoc;
+    if (!ParseRegister(RegNo, StartLoc, EndLoc)) {
+      Operands.push_back(TNTOperand::CreateReg(RegNo, StartLoc, EndLoc));
+      return false;
+    }
+    // Fall through
+  }
+  case AsmToken::Integer:
+  case AsmToken::Plus:
+  case AsmToken::Minus:
+  case AsmToken::Dollar: {
+    SMLoc StartLoc = getParser().getTok().getLoc();
+    const MCExpr *Val;
+    // Try constexpr[(rN)]
+    if (!getParser().parseExpression(Val)) {
+      unsigned RegNo = TNT::PC;
+      SMLoc EndLoc = getParser().getTok().getLoc();
+      // Try (rN)
+      if (getLexer().getKind() == AsmToken::LParen) {
+        getLexer().Lex(); // Eat '('
+        SMLoc RegStartLoc = getLexer().getLoc();
+        if (ParseRegister(RegNo, RegStartLoc, EndLoc))
+          return Error(RegStartLoc, "expected register");
+        if (getLexer().getKind() != AsmToken::RParen)
+          return Error(getLexer().getLoc(), "expected ')'");
+        EndLoc = getParser().getTok().getEndLoc();
+        getLexer().Lex(); // Eat ')'
+        Operands.push_back(
+            TNTOperand::CreateMem(RegNo, Val, StartLoc, EndLoc));
+        return false;
+      }
+      // Symbolic (PC relative) addressing is not supported.
+      return Error(StartLoc, "expected '#', '&' or indexed operand");
+    }
+    return true;
+  }
+  case AsmToken::Amp: {
+    // Try &constexpr
+    SMLoc StartLoc = getParser().getTok().getLoc();
+    getLexer().Lex(); // Eat '&'
+    const MCExpr *Val;
+    if (!getParser().parseExpression(Val)) {
+      SMLoc EndLoc = getParser().getTok().getLoc();
+      Operands.push_back(TNTOperand::CreateMem(0, Val, StartLoc, EndLoc));
+      return false;
+    }
+    return true;
+  }
+  case AsmToken::At: {
+    // Try @rN[+]
+    SMLoc StartLoc = getParser().getTok().getLoc();
+    getLexer().Lex(); // Eat '@'
+    unsigned RegNo;
+    SMLoc RegStartLoc = getLexer().getLoc(), EndLoc;
+    if (ParseRegister(RegNo, RegStartLoc, EndLoc))
+      return Error(RegStartLoc, "expected register");
+    if (getLexer().getKind() == AsmToken::Plus) {
+      Operands.push_back(TNTOperand::CreateToken("@", StartLoc));
+      Operands.push_back(TNTOperand::CreateReg(RegNo, RegStartLoc, EndLoc));
+      Operands.push_back(
+          TNTOperand::CreateToken("+", getParser().getTok().getLoc()));
+      getLexer().Lex(); // Eat '+'
+      return false;
+    }
+    // There are no register indirect instructions; use the equivalent
+    // indexed form.
+    Operands.push_back(TNTOperand::CreateMem(
+        RegNo, MCConstantExpr::create(0, getContext()), StartLoc, EndLoc));
+    return false;
+  }
+  case AsmToken::Hash:
+    // Try #constexpr
+    SMLoc StartLoc = getParser().getTok().getLoc();
+    getLexer().Lex(); // Eat '#'
+    const MCExpr *Val;
+    if (!getParser().parseExpression(Val)) {
+      SMLoc EndLoc = getParser().getTok().getLoc();
+      Operands.push_back(TNTOperand::CreateImm(Val, StartLoc, EndLoc));
+      return false;
+    }
+    return true;
+  }
+}
+
+void TNTAsmParser::cvtPostInc(MCInst &Inst, const OperandVector &Operands) {
+  // Operands are: mnemonic, '@', source register, '+', destination.
+  const TNTOperand &Src = static_cast<const TNTOperand &>(*Operands[2]);
+  const TNTOperand &Dst = static_cast<const TNTOperand &>(*Operands[4]);
+
+  // Memory to memory move.
+  if (Dst.isMem()) {
+    Src.addRegOperands(Inst, 1); // wb
+    Dst.addMemOperands(Inst, 2); // dst
+    Src.addRegOperands(Inst, 1); // rs
+    return;
+  }
+
+  Dst.addRegOperands(Inst, 1); // rd
+  Src.addRegOperands(Inst, 1); // wb
+  // Arithmetic forms also read the destination.
+  if (MII.get(Inst.getOpcode()).getNumOperands() == 4)
+    Dst.addRegOperands(Inst, 1); // src2
+  Src.addRegOperands(Inst, 1); // rs
+}
+
+extern "C" void LLVMInitializeTNTAsmParser() {
+  RegisterMCAsmParser<TNTAsmParser> X(TheTNTTarget);
+}
+
+#define GET_MATCHER_IMPLEMENTATION
+#include "TNTGenAsmMatcher.inc"
+
+static unsigned convertGR16ToGR8(const MCRegisterInfo *MRI, unsigned Reg) {
+  return MRI->getSubReg(Reg, TNT::subreg_8bit);
+}
+
+unsigned TNTAsmParser::validateTargetOperandClass(MCParsedAsmOperand &AsmOp,
+                                                  unsigned Kind) {
+  TNTOperand &Op = static_cast<TNTOperand &>(AsmOp);
+
+  if (!Op.isReg())
+    return Match_InvalidOperand;
+
+  // Registers are always parsed as the 16-bit ones; byte instructions use
+  // their 8-bit halves, which share the names.
+  unsigned Reg = Op.getReg();
+  bool isGR16 =
+      TNTMCRegisterClasses[TNT::GR16RegClassID].contains(Reg);
+
+  if (isGR16 && (Kind == MCK_GR8)) {
+    Op.setReg(convertGR16ToGR8(MRI, Reg));
+    return Match_Success;
+  }
+
+  return Match_InvalidOperand;
+}
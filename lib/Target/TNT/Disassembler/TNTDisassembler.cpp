@@ -0,0 +1,210 @@
+//===-- TNTDisassembler.cpp - Disassembler for TNT ------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the TNTDisassembler class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "TNT.h"
+#include "MCTargetDesc/TNTMCTargetDesc.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCDisassembler/MCDisassembler.h"
+#include "llvm/MC/MCFixedLenDisassembler.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TargetRegistry.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "tnt-disassembler"
+
+typedef MCDisassembler::DecodeStatus DecodeStatus;
+
+namespace {
+
+/// A disassembler class for TNT.
+class TNTDisassembler : public MCDisassembler {
+public:
+  TNTDisassembler(const MCSubtargetInfo &STI, MCContext &Ctx)
+      : MCDisassembler(STI, Ctx) {}
+  ~TNTDisassembler() override {}
+
+  DecodeStatus getInstruction(MCInst &Instr, uint64_t &Size,
+                              ArrayRef<uint8_t> Bytes, uint64_t Address,
+                              raw_ostream &VStream,
+                              raw_ostream &CStream) const override;
+};
+
+} // end anonymous namespace
+
+static MCDisassembler *createTNTDisassembler(const Target &T,
+                                             const MCSubtargetInfo &STI,
+                                             MCContext &Ctx) {
+  return new TNTDisassembler(STI, Ctx);
+}
+
+extern "C" void LLVMInitializeTNTDisassembler() {
+  // Register the disassembler.
+  TargetRegistry::RegisterMCDisassembler(TheTNTTarget,
+                                         createTNTDisassembler);
+}
+
+static const unsigned GR8DecoderTable[] = {
+  TNT::PCB,  TNT::SPB,  TNT::SRB,  TNT::CGB,
+  TNT::FPB,  TNT::R5B,  TNT::R6B,  TNT::R7B,
+  TNT::R8B,  TNT::R9B,  TNT::R10B, TNT::R11B,
+  TNT::R12B, TNT::R13B, TNT::R14B, TNT::R15B
+};
+
+static DecodeStatus DecodeGR8RegisterClass(MCInst &Inst, unsigned RegNo,
+                                           uint64_t Address,
+                                           const void *Decoder) {
+  if (RegNo > 15)
+    return MCDisassembler::Fail;
+
+  Inst.addOperand(MCOperand::createReg(GR8DecoderTable[RegNo]));
+  return MCDisassembler::Success;
+}
+
+static const unsigned GR16DecoderTable[] = {
+  TNT::PC,  TNT::SP,  TNT::SR,  TNT::CG,
+  TNT::FP,  TNT::R5,  TNT::R6,  TNT::R7,
+  TNT::R8,  TNT::R9,  TNT::R10, TNT::R11,
+  TNT::R12, TNT::R13, TNT::R14, TNT::R15
+};
+
+static DecodeStatus DecodeGR16RegisterClass(MCInst &Inst, unsigned RegNo,
+                                            uint64_t Address,
+                                            const void *Decoder) {
+  if (RegNo > 15)
+    return MCDisassembler::Fail;
+
+  Inst.addOperand(MCOperand::createReg(GR16DecoderTable[RegNo]));
+  return MCDisassembler::Success;
+}
+
+// Memory operands are the register in bits 3-0 and the index in bits 19-4.
+// Indexed mode off SR is absolute addressing, which codegen represents with
+// a null base register.
+static DecodeStatus DecodeMemOperand(MCInst &Inst, unsigned Bits,
+                                     uint64_t Address, const void *Decoder) {
+  unsigned Reg = Bits & 0xf;
+  int16_t Index = static_cast<int16_t>((Bits >> 4) & 0xffff);
+
+  Inst.addOperand(MCOperand::createReg(Reg == 2 ? 0 : GR16DecoderTable[Reg]));
+  Inst.addOperand(MCOperand::createImm(Index));
+  return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodePCRelImm(MCInst &Inst, unsigned Bits,
+                                   uint64_t Address, const void *Decoder) {
+  Inst.addOperand(MCOperand::createImm(SignExtend32<10>(Bits)));
+  return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodeCCOperand(MCInst &Inst, unsigned Bits,
+                                    uint64_t Address, const void *Decoder) {
+  TNTCC::CondCodes CC;
+  switch (Bits) {
+  case 0: CC = TNTCC::COND_NE; break;
+  case 1: CC = TNTCC::COND_E;  break;
+  case 2: CC = TNTCC::COND_LO; break;
+  case 3: CC = TNTCC::COND_HS; break;
+  case 4: CC = TNTCC::COND_N;  break;
+  case 5: CC = TNTCC::COND_GE; break;
+  case 6: CC = TNTCC::COND_L;  break;
+  default:
+    return MCDisassembler::Fail;
+  }
+
+  Inst.addOperand(MCOperand::createImm(CC));
+  return MCDisassembler::Success;
+}
+
+static DecodeStatus DecodeCGImm(MCInst &Inst, unsigned Bits,
+                                uint64_t Address, const void *Decoder) {
+  int64_t Imm;
+  switch (Bits) {
+  case 0x03: Imm =  0; break;
+  case 0x13: Imm =  1; break;
+  case 0x23: Imm =  2; break;
+  case 0x33: Imm = -1; break;
+  case 0x22: Imm =  4; break;
+  case 0x32: Imm =  8; break;
+  default:
+    return MCDisassembler::Fail;
+  }
+
+  Inst.addOperand(MCOperand::createImm(Imm));
+  return MCDisassembler::Success;
+}
+
+#include "TNTGenDisassemblerTables.inc"
+
+DecodeStatus TNTDisassembler::getInstruction(MCInst &MI, uint64_t &Size,
+                                             ArrayRef<uint8_t> Bytes,
+                                             uint64_t Address,
+                                             raw_ostream &VStream,
+                                             raw_ostream &CStream) const {
+  if (Bytes.size() < 2) {
+    Size = 0;
+    return MCDisassembler::Fail;
+  }
+
+  uint64_t Insn = support::endian::read16le(Bytes.data());
+
+  // Work out from the first word how many extension words follow, and
+  // whether the source operand comes from a constant generator.
+  unsigned Words = 1;
+  bool IsCG = false;
+  if ((Insn & 0xe000) != 0x2000) {
+    bool IsSingleOp = (Insn & 0xfc00) == 0x1000;
+    unsigned As = (Insn >> 4) & 0x3;
+    unsigned Rs = IsSingleOp ? Insn & 0xf : (Insn >> 8) & 0xf;
+
+    if (Rs == 3 || (Rs == 2 && As >= 2))
+      IsCG = true;
+    else if (As == 1 || (As == 3 && Rs == 0))
+      ++Words;
+
+    // Indexed / absolute destination.
+    if (!IsSingleOp && (Insn & 0x80))
+      ++Words;
+  }
+
+  if (Bytes.size() < Words * 2) {
+    Size = 0;
+    return MCDisassembler::Fail;
+  }
+
+  for (unsigned i = 1; i != Words; ++i)
+    Insn |= uint64_t(support::endian::read16le(Bytes.data() + i * 2))
+            << (i * 16);
+
+  const uint8_t *Table;
+  switch (Words) {
+  default: llvm_unreachable("Invalid instruction size");
+  case 1: Table = IsCG ? DecoderTableCG16 : DecoderTable16; break;
+  case 2: Table = IsCG ? DecoderTableCG32 : DecoderTable32; break;
+  case 3: Table = DecoderTable48; break;
+  }
+
+  DecodeStatus Result =
+      decodeInstruction(Table, MI, Insn, Address, this, STI);
+  if (Result == MCDisassembler::Fail) {
+    Size = 2;
+    return MCDisassembler::Fail;
+  }
+
+  Size = Words * 2;
+  return Result;
+}
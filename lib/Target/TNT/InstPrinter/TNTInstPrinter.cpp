@@ -35,9 +35,15 @@ void TNTInstPrinter::printInst(const MCInst *MI, raw_ostream &O,
 void TNTInstPrinter::printPCRelImmOperand(const MCInst *MI, unsigned OpNo,
                                              raw_ostream &O) {
   const MCOperand &Op = MI->getOperand(OpNo);
-  if (Op.isImm())
-    O << Op.getImm();
-  else {
+  if (Op.isImm()) {
+    // The immediate is the word offset from the word following the jump;
+    // print it as a byte offset from the jump itself.
+    int64_t Imm = Op.getImm() * 2 + 2;
+    O << '$';
+    if (Imm >= 0)
+      O << '+';
+    O << Imm;
+  } else {
     assert(Op.isExpr() && "unknown pcrel immediate operand");
     Op.getExpr()->print(O, &MAI);
   }
@@ -112,5 +118,8 @@ void TNTInstPrinter::printCCOperand(const MCInst *MI, unsigned OpNo,
   case TNTCC::COND_L:
    O << 'l';
    break;
+  case TNTCC::COND_N:
+   O << 'n';
+   break;
   }
 }
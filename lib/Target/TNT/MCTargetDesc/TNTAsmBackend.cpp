@@ -7,101 +7,226 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "TNT.h"
+#include "MCTargetDesc/TNTFixupKinds.h"
 #include "MCTargetDesc/TNTMCTargetDesc.h"
 #include "llvm/MC/MCAsmBackend.h"
 #include "llvm/MC/MCAssembler.h"
+#include "llvm/MC/MCContext.h"
 #include "llvm/MC/MCDirectives.h"
 #include "llvm/MC/MCELFObjectWriter.h"
 #include "llvm/MC/MCFixupKindInfo.h"
+#include "llvm/MC/MCFragment.h"
+#include "llvm/MC/MCInst.h"
 #include "llvm/MC/MCObjectWriter.h"
 #include "llvm/MC/MCSubtargetInfo.h"
-#include "llvm/MC/MCExpr.h"
-#include "llvm/MC/MCSymbol.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
 
+// Prepare value for the target space
+static uint64_t adjustFixupValue(unsigned Kind, uint64_t Value,
+                                 MCContext *Ctx = nullptr,
+                                 SMLoc Loc = SMLoc()) {
+  switch (Kind) {
+  case FK_Data_1:
+  case FK_Data_2:
+  case FK_Data_4:
+  case TNT::fixup_16_byte:
+    return Value;
+  case TNT::fixup_10_pcrel: {
+    // The jump offset is counted in words from the word following the jump;
+    // processFixupValue has already moved Value to be relative to that word.
+    if (Ctx && (Value & 1))
+      Ctx->reportError(Loc, "fixup value must be 2-byte aligned");
+    int64_t Offset = static_cast<int64_t>(Value) >> 1;
+    if (Ctx && !isInt<10>(Offset))
+      Ctx->reportError(Loc, "fixup value out of range");
+    return Offset & 0x3ff;
+  }
+  default:
+    llvm_unreachable("Unknown fixup kind!");
+  }
+}
+
 namespace {
 class TNTAsmBackend : public MCAsmBackend {
-public:
-  bool IsLittleEndian;
+  uint8_t OSABI;
 
-  TNTAsmBackend(bool IsLittleEndian)
-    : MCAsmBackend(), IsLittleEndian(IsLittleEndian) {}
+public:
+  TNTAsmBackend(uint8_t OSABI) : MCAsmBackend(), OSABI(OSABI) {}
   ~TNTAsmBackend() override {}
 
   void applyFixup(const MCFixup &Fixup, char *Data, unsigned DataSize,
                   uint64_t Value, bool IsPCRel) const override;
 
+  void processFixupValue(const MCAssembler &Asm, const MCAsmLayout &Layout,
+                         const MCFixup &Fixup, const MCFragment *DF,
+                         const MCValue &Target, uint64_t &Value,
+                         bool &IsResolved) override;
+
   MCObjectWriter *createObjectWriter(raw_pwrite_stream &OS) const override;
 
-  // No instruction requires relaxation
   bool fixupNeedsRelaxation(const MCFixup &Fixup, uint64_t Value,
                             const MCRelaxableFragment *DF,
-                            const MCAsmLayout &Layout) const override {
-    return false;
-  }
+                            const MCAsmLayout &Layout) const override;
+
+  const MCFixupKindInfo &getFixupKindInfo(MCFixupKind Kind) const override;
 
-  unsigned getNumFixupKinds() const override { return 1; }
+  unsigned getNumFixupKinds() const override {
+    return TNT::NumTargetFixupKinds;
+  }
 
-  bool mayNeedRelaxation(const MCInst &Inst) const override { return false; }
+  bool mayNeedRelaxation(const MCInst &Inst) const override;
 
   void relaxInstruction(const MCInst &Inst, const MCSubtargetInfo &STI,
-                        MCInst &Res) const override {}
+                        MCInst &Res) const override;
 
   bool writeNopData(uint64_t Count, MCObjectWriter *OW) const override;
 };
+} // end anonymous namespace
 
 bool TNTAsmBackend::writeNopData(uint64_t Count, MCObjectWriter *OW) const {
-  if ((Count % 8) != 0)
+  if ((Count % 2) != 0)
     return false;
 
-  for (uint64_t i = 0; i < Count; i += 8)
-    OW->write64(0x15000000);
+  // The canonical nop on TNT is "mov r3, r3".
+  for (uint64_t i = 0; i < Count; i += 2)
+    OW->write16(0x4303);
 
   return true;
 }
 
+bool TNTAsmBackend::mayNeedRelaxation(const MCInst &Inst) const {
+  switch (Inst.getOpcode()) {
+  default:
+    return false;
+  case TNT::JMP:
+    return true;
+  case TNT::JCC:
+    // jn has no inverse, so it cannot be turned into a long branch.
+    return Inst.getOperand(1).getImm() != TNTCC::COND_N;
+  }
+}
+
+bool TNTAsmBackend::fixupNeedsRelaxation(const MCFixup &Fixup, uint64_t Value,
+                                         const MCRelaxableFragment *DF,
+                                         const MCAsmLayout &Layout) const {
+  if (Fixup.getKind() != static_cast<MCFixupKind>(TNT::fixup_10_pcrel))
+    return false;
+
+  // Relax whenever the word offset does not fit the 10 bit jump field.
+  int64_t Offset = static_cast<int64_t>(Value) >> 1;
+  return !isInt<10>(Offset);
+}
+
+// Turn a short jump into a long one:
+//   jmp dst  ->  br #dst
+//   jCC dst  ->  j!CC $+6; br #dst
+void TNTAsmBackend::relaxInstruction(const MCInst &Inst,
+                                     const MCSubtargetInfo &STI,
+                                     MCInst &Res) const {
+  Res = MCInst();
+  Res.setLoc(Inst.getLoc());
+
+  if (Inst.getOpcode() == TNT::JMP) {
+    Res.setOpcode(TNT::Bi);
+    Res.addOperand(Inst.getOperand(0));
+    return;
+  }
+
+  assert(Inst.getOpcode() == TNT::JCC && "Unexpected instruction to relax");
+  TNTCC::CondCodes CC;
+  switch (Inst.getOperand(1).getImm()) {
+  default: llvm_unreachable("Invalid branch condition!");
+  case TNTCC::COND_E:  CC = TNTCC::COND_NE; break;
+  case TNTCC::COND_NE: CC = TNTCC::COND_E;  break;
+  case TNTCC::COND_L:  CC = TNTCC::COND_GE; break;
+  case TNTCC::COND_GE: CC = TNTCC::COND_L;  break;
+  case TNTCC::COND_HS: CC = TNTCC::COND_LO; break;
+  case TNTCC::COND_LO: CC = TNTCC::COND_HS; break;
+  }
+
+  Res.setOpcode(TNT::JCCL);
+  Res.addOperand(Inst.getOperand(0));
+  Res.addOperand(MCOperand::createImm(CC));
+}
+
+void TNTAsmBackend::processFixupValue(const MCAssembler &Asm,
+                                      const MCAsmLayout &Layout,
+                                      const MCFixup &Fixup,
+                                      const MCFragment *DF,
+                                      const MCValue &Target, uint64_t &Value,
+                                      bool &IsResolved) {
+  // Only a resolved jump is biased by the word following it. A jump left for
+  // the linker has its value cleared by the object writer and must keep an
+  // empty offset field; the relocation accounts for the bias.
+  if (IsResolved &&
+      Fixup.getKind() == static_cast<MCFixupKind>(TNT::fixup_10_pcrel))
+    Value -= 2;
+
+  // A jump that may still be relaxed is diagnosed once layout is final.
+  if (const auto *RF = dyn_cast<MCRelaxableFragment>(DF))
+    if (mayNeedRelaxation(RF->getInst()))
+      return;
+
+  // Only diagnose here; the value itself is adjusted in applyFixup.
+  if (IsResolved)
+    (void)adjustFixupValue(Fixup.getKind(), Value, &Asm.getContext(),
+                           Fixup.getLoc());
+}
+
 void TNTAsmBackend::applyFixup(const MCFixup &Fixup, char *Data,
                                unsigned DataSize, uint64_t Value,
                                bool IsPCRel) const {
-
-  if (Fixup.getKind() == FK_SecRel_4 || Fixup.getKind() == FK_SecRel_8) {
-    assert(Value == 0);
-  } else if (Fixup.getKind() == FK_Data_4 || Fixup.getKind() == FK_Data_8) {
-    unsigned Size = Fixup.getKind() == FK_Data_4 ? 4 : 8;
-
-    for (unsigned i = 0; i != Size; ++i) {
-      unsigned Idx = IsLittleEndian ? i : Size - i;
-      Data[Fixup.getOffset() + Idx] = uint8_t(Value >> (i * 8));
-    }
-  } else {
-    assert(Fixup.getKind() == FK_PCRel_2);
-    Value = (uint16_t)((Value - 8) / 8);
-    if (IsLittleEndian) {
-      Data[Fixup.getOffset() + 2] = Value & 0xFF;
-      Data[Fixup.getOffset() + 3] = Value >> 8;
-    } else {
-      Data[Fixup.getOffset() + 2] = Value >> 8;
-      Data[Fixup.getOffset() + 3] = Value & 0xFF;
-    }
-  }
+  MCFixupKind Kind = Fixup.getKind();
+  Value = adjustFixupValue(Kind, Value);
+  if (!Value)
+    return; // This value doesn't change the encoding
+
+  const MCFixupKindInfo &Info = getFixupKindInfo(Kind);
+  unsigned Offset = Fixup.getOffset();
+  unsigned NumBytes = (Info.TargetOffset + Info.TargetSize + 7) / 8;
+  assert(Offset + NumBytes <= DataSize && "Invalid fixup offset!");
+
+  // Shift the value into position and mask out any bits that do not fit.
+  Value <<= Info.TargetOffset;
+  if (Info.TargetSize < 64)
+    Value &= (uint64_t(1) << (Info.TargetOffset + Info.TargetSize)) - 1;
+
+  // Instructions and data are both little-endian; OR the value into the
+  // bits already emitted for the fixup.
+  for (unsigned i = 0; i != NumBytes; ++i)
+    Data[Offset + i] |= uint8_t((Value >> (i * 8)) & 0xff);
 }
 
 MCObjectWriter *TNTAsmBackend::createObjectWriter(raw_pwrite_stream &OS) const {
-  return createTNTELFObjectWriter(OS, 0, IsLittleEndian);
+  return createTNTELFObjectWriter(OS, OSABI);
 }
+
+const MCFixupKindInfo &TNTAsmBackend::getFixupKindInfo(MCFixupKind Kind) const {
+  static const MCFixupKindInfo Infos[TNT::NumTargetFixupKinds] = {
+    // This table *must* be in the order that the fixup_* kinds are defined in
+    // TNTFixupKinds.h.
+    //
+    // name             offset bits flags
+    { "fixup_10_pcrel", 0,     10,  MCFixupKindInfo::FKF_IsPCRel },
+    { "fixup_16_byte",  0,     16,  0 },
+  };
+
+  if (Kind < FirstTargetFixupKind)
+    return MCAsmBackend::getFixupKindInfo(Kind);
+
+  assert(unsigned(Kind - FirstTargetFixupKind) < getNumFixupKinds() &&
+         "Invalid kind!");
+  return Infos[Kind - FirstTargetFixupKind];
 }
 
 MCAsmBackend *llvm::createTNTAsmBackend(const Target &T,
                                         const MCRegisterInfo &MRI,
                                         const Triple &TT, StringRef CPU) {
-  return new TNTAsmBackend(/*IsLittleEndian=*/true);
-}
-
-MCAsmBackend *llvm::createTNTbeAsmBackend(const Target &T,
-                                          const MCRegisterInfo &MRI,
-                                          const Triple &TT, StringRef CPU) {
-  return new TNTAsmBackend(/*IsLittleEndian=*/false);
+  uint8_t OSABI = MCELFObjectTargetWriter::getOSABI(TT.getOS());
+  return new TNTAsmBackend(OSABI);
 }
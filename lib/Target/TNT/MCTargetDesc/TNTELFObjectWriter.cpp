@@ -7,6 +7,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "MCTargetDesc/TNTFixupKinds.h"
 #include "MCTargetDesc/TNTMCTargetDesc.h"
 #include "llvm/MC/MCELFObjectWriter.h"
 #include "llvm/MC/MCFixup.h"
@@ -27,9 +28,11 @@ protected:
 };
 }
 
+// TNT shares the MSP430 instruction set, so objects are tagged EM_MSP430 and
+// use the MSP430 ELF ABI relocations.
 TNTELFObjectWriter::TNTELFObjectWriter(uint8_t OSABI)
-    : MCELFObjectTargetWriter(/*Is64Bit*/ true, OSABI, ELF::EM_TNT,
-                              /*HasRelocationAddend*/ false) {}
+    : MCELFObjectTargetWriter(/*Is64Bit*/ false, OSABI, ELF::EM_MSP430,
+                              /*HasRelocationAddend*/ true) {}
 
 TNTELFObjectWriter::~TNTELFObjectWriter() {}
 
@@ -40,19 +43,21 @@ unsigned TNTELFObjectWriter::getRelocType(MCContext &Ctx, const MCValue &Target,
   switch ((unsigned)Fixup.getKind()) {
   default:
     llvm_unreachable("invalid fixup kind!");
-  case FK_SecRel_8:
-    return ELF::R_X86_64_64;
-  case FK_SecRel_4:
-    return ELF::R_X86_64_PC32;
-  case FK_Data_8:
-    return IsPCRel ? ELF::R_X86_64_PC64 : ELF::R_X86_64_64;
+  case FK_Data_1:
+    return ELF::R_MSP430_8;
+  case FK_Data_2:
+    return ELF::R_MSP430_16;
   case FK_Data_4:
-    return IsPCRel ? ELF::R_X86_64_PC32 : ELF::R_X86_64_32;
+    return ELF::R_MSP430_32;
+  case TNT::fixup_10_pcrel:
+    return ELF::R_MSP430_10_PCREL;
+  case TNT::fixup_16_byte:
+    return ELF::R_MSP430_16_BYTE;
   }
 }
 
 MCObjectWriter *llvm::createTNTELFObjectWriter(raw_pwrite_stream &OS,
-                                               uint8_t OSABI, bool IsLittleEndian) {
+                                               uint8_t OSABI) {
   MCELFObjectTargetWriter *MOTW = new TNTELFObjectWriter(OSABI);
-  return createELFObjectWriter(MOTW, OS, IsLittleEndian);
+  return createELFObjectWriter(MOTW, OS, /*IsLittleEndian*/ true);
 }
@@ -0,0 +1,37 @@
+//===-- TNTFixupKinds.h - TNT Specific Fixup Entries ------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_TARGET_TNT_MCTARGETDESC_TNTFIXUPKINDS_H
+#define LLVM_LIB_TARGET_TNT_MCTARGETDESC_TNTFIXUPKINDS_H
+
+#include "llvm/MC/MCFixup.h"
+
+namespace llvm {
+namespace TNT {
+// This table *must* be in the same order as
+// MCFixupKindInfo Infos[TNT::NumTargetFixupKinds]
+// in TNTAsmBackend.cpp.
+//
+enum Fixups {
+  // 10-bit PC relative word offset of a conditional/unconditional jump.
+  // Results in R_MSP430_10_PCREL.
+  fixup_10_pcrel = FirstTargetFixupKind,
+
+  // 16-bit absolute value placed in an extension word of an instruction.
+  // Results in R_MSP430_16_BYTE.
+  fixup_16_byte,
+
+  // Marker
+  LastTargetFixupKind,
+  NumTargetFixupKinds = LastTargetFixupKind - FirstTargetFixupKind
+};
+} // namespace TNT
+} // namespace llvm
+
+#endif // LLVM_LIB_TARGET_TNT_MCTARGETDESC_TNTFIXUPKINDS_H
@@ -20,6 +20,7 @@ TNTMCAsmInfo::TNTMCAsmInfo(const Triple &TT) {
   PointerSize = CalleeSaveStackSlotSize = 2;
 
   CommentString = ";";
+  DollarIsPC = true;
 
   AlignmentIsInBytes = false;
   UsesELFSectionDirectiveForBSS = true;
@@ -11,15 +11,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "TNT.h"
+#include "MCTargetDesc/TNTFixupKinds.h"
 #include "MCTargetDesc/TNTMCTargetDesc.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCExpr.h"
 #include "llvm/MC/MCFixup.h"
 #include "llvm/MC/MCInst.h"
 #include "llvm/MC/MCInstrInfo.h"
 #include "llvm/MC/MCRegisterInfo.h"
 #include "llvm/MC/MCSubtargetInfo.h"
-#include "llvm/MC/MCSymbol.h"
-#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/raw_ostream.h"
 using namespace llvm;
@@ -30,14 +33,20 @@ namespace {
 class TNTMCCodeEmitter : public MCCodeEmitter {
   TNTMCCodeEmitter(const TNTMCCodeEmitter &) = delete;
   void operator=(const TNTMCCodeEmitter &) = delete;
-  const MCRegisterInfo &MRI;
-  bool IsLittleEndian;
+  MCContext &Ctx;
+  const MCInstrInfo &MCII;
+
+  // Offset (in bytes) of the next extension word of the instruction being
+  // encoded. Operands are encoded in the order their extension words follow
+  // the first instruction word, so this is advanced by each operand that
+  // occupies one.
+  mutable unsigned Offset;
 
 public:
-  TNTMCCodeEmitter(const MCRegisterInfo &mri, bool IsLittleEndian)
-    : MRI(mri), IsLittleEndian(IsLittleEndian) {}
+  TNTMCCodeEmitter(MCContext &ctx, const MCInstrInfo &mcii)
+    : Ctx(ctx), MCII(mcii) {}
 
-  ~TNTMCCodeEmitter() {}
+  ~TNTMCCodeEmitter() override {}
 
   // getBinaryCodeForInstr - TableGen'erated function for getting the
   // binary encoding for an instruction.
@@ -45,32 +54,58 @@ public:
                                  SmallVectorImpl<MCFixup> &Fixups,
                                  const MCSubtargetInfo &STI) const;
 
-  // getMachineOpValue - Return binary encoding of operand. If the machin
+  // getMachineOpValue - Return binary encoding of operand. If the machine
   // operand requires relocation, record the relocation and return zero.
   unsigned getMachineOpValue(const MCInst &MI, const MCOperand &MO,
                              SmallVectorImpl<MCFixup> &Fixups,
                              const MCSubtargetInfo &STI) const;
 
-  uint64_t getMemoryOpValue(const MCInst &MI, unsigned Op,
-                            SmallVectorImpl<MCFixup> &Fixups,
-                            const MCSubtargetInfo &STI) const;
+  // getMemOpValue - Return the register in bits 3-0 and the displacement in
+  // bits 19-4 of the (base, disp) memory operand pair.
+  unsigned getMemOpValue(const MCInst &MI, unsigned Op,
+                         SmallVectorImpl<MCFixup> &Fixups,
+                         const MCSubtargetInfo &STI) const;
+
+  unsigned getPCRelImmOpValue(const MCInst &MI, unsigned Op,
+                              SmallVectorImpl<MCFixup> &Fixups,
+                              const MCSubtargetInfo &STI) const;
+
+  unsigned getCCOpValue(const MCInst &MI, unsigned Op,
+                        SmallVectorImpl<MCFixup> &Fixups,
+                        const MCSubtargetInfo &STI) const;
+
+  // getCGImmOpValue - Return the As mode in bits 5-4 and the constant
+  // generator register in bits 3-0 for a constant generator immediate.
+  unsigned getCGImmOpValue(const MCInst &MI, unsigned Op,
+                           SmallVectorImpl<MCFixup> &Fixups,
+                           const MCSubtargetInfo &STI) const;
 
   void encodeInstruction(const MCInst &MI, raw_ostream &OS,
                          SmallVectorImpl<MCFixup> &Fixups,
                          const MCSubtargetInfo &STI) const override;
 };
-}
+} // end anonymous namespace
 
 MCCodeEmitter *llvm::createTNTMCCodeEmitter(const MCInstrInfo &MCII,
                                             const MCRegisterInfo &MRI,
                                             MCContext &Ctx) {
-  return new TNTMCCodeEmitter(MRI, true);
+  return new TNTMCCodeEmitter(Ctx, MCII);
 }
 
-MCCodeEmitter *llvm::createTNTbeMCCodeEmitter(const MCInstrInfo &MCII,
-                                              const MCRegisterInfo &MRI,
-                                              MCContext &Ctx) {
-  return new TNTMCCodeEmitter(MRI, false);
+void TNTMCCodeEmitter::encodeInstruction(const MCInst &MI, raw_ostream &OS,
+                                         SmallVectorImpl<MCFixup> &Fixups,
+                                         const MCSubtargetInfo &STI) const {
+  const MCInstrDesc &Desc = MCII.get(MI.getOpcode());
+  unsigned Size = Desc.getSize();
+
+  // Extension words start right after the first instruction word. The long
+  // conditional jump has the opcode word of its "br" in between.
+  Offset = MI.getOpcode() == TNT::JCCL ? 4 : 2;
+
+  uint64_t BinaryOpCode = getBinaryCodeForInstr(MI, Fixups, STI);
+  support::endian::Writer<support::little> LE(OS);
+  for (unsigned i = 0; i != Size / 2; ++i, BinaryOpCode >>= 16)
+    LE.write<uint16_t>(BinaryOpCode & 0xffff);
 }
 
 unsigned TNTMCCodeEmitter::getMachineOpValue(const MCInst &MI,
@@ -78,91 +113,90 @@ unsigned TNTMCCodeEmitter::getMachineOpValue(const MCInst &MI,
                                              SmallVectorImpl<MCFixup> &Fixups,
                                              const MCSubtargetInfo &STI) const {
   if (MO.isReg())
-    return MRI.getEncodingValue(MO.getReg());
-  if (MO.isImm())
-    return static_cast<unsigned>(MO.getImm());
-
-  assert(MO.isExpr());
+    return Ctx.getRegisterInfo()->getEncodingValue(MO.getReg());
 
-  const MCExpr *Expr = MO.getExpr();
+  if (MO.isImm()) {
+    Offset += 2;
+    return static_cast<unsigned>(MO.getImm()) & 0xffff;
+  }
 
-  assert(Expr->getKind() == MCExpr::SymbolRef);
+  assert(MO.isExpr() && "Expected expr operand");
+  Fixups.push_back(MCFixup::create(Offset, MO.getExpr(),
+      static_cast<MCFixupKind>(TNT::fixup_16_byte), MI.getLoc()));
+  Offset += 2;
+  return 0;
+}
 
-  if (MI.getOpcode() == TNT::JAL)
-    // func call name
-    Fixups.push_back(MCFixup::create(0, Expr, FK_SecRel_4));
-  else if (MI.getOpcode() == TNT::LD_imm64)
-    Fixups.push_back(MCFixup::create(0, Expr, FK_SecRel_8));
-  else
-    // bb label
-    Fixups.push_back(MCFixup::create(0, Expr, FK_PCRel_2));
+unsigned TNTMCCodeEmitter::getMemOpValue(const MCInst &MI, unsigned Op,
+                                         SmallVectorImpl<MCFixup> &Fixups,
+                                         const MCSubtargetInfo &STI) const {
+  const MCOperand &MO1 = MI.getOperand(Op);
+  assert(MO1.isReg() && "Register operand expected");
+  unsigned Reg = MO1.getReg();
+
+  // Absolute addresses are encoded as indexed mode with SR as the base.
+  unsigned Encoding = Reg ? Ctx.getRegisterInfo()->getEncodingValue(Reg)
+                          : Ctx.getRegisterInfo()->getEncodingValue(TNT::SR);
+
+  const MCOperand &MO2 = MI.getOperand(Op + 1);
+  if (MO2.isImm()) {
+    Offset += 2;
+    return ((static_cast<unsigned>(MO2.getImm()) & 0xffff) << 4) | Encoding;
+  }
 
-  return 0;
+  assert(MO2.isExpr() && "Expr operand expected");
+  Fixups.push_back(MCFixup::create(Offset, MO2.getExpr(),
+      static_cast<MCFixupKind>(TNT::fixup_16_byte), MI.getLoc()));
+  Offset += 2;
+  return Encoding;
 }
 
-static uint8_t SwapBits(uint8_t Val)
-{
-  return (Val & 0x0F) << 4 | (Val & 0xF0) >> 4;
+unsigned TNTMCCodeEmitter::getPCRelImmOpValue(const MCInst &MI, unsigned Op,
+                                              SmallVectorImpl<MCFixup> &Fixups,
+                                              const MCSubtargetInfo &STI) const {
+  const MCOperand &MO = MI.getOperand(Op);
+  if (MO.isImm())
+    return static_cast<unsigned>(MO.getImm()) & 0x3ff;
+
+  assert(MO.isExpr() && "Expr operand expected");
+  Fixups.push_back(MCFixup::create(0, MO.getExpr(),
+      static_cast<MCFixupKind>(TNT::fixup_10_pcrel), MI.getLoc()));
+  return 0;
 }
 
-void TNTMCCodeEmitter::encodeInstruction(const MCInst &MI, raw_ostream &OS,
-                                         SmallVectorImpl<MCFixup> &Fixups,
-                                         const MCSubtargetInfo &STI) const {
-  unsigned Opcode = MI.getOpcode();
-  support::endian::Writer<support::little> LE(OS);
-  support::endian::Writer<support::big> BE(OS);
-
-  if (Opcode == TNT::LD_imm64 || Opcode == TNT::LD_pseudo) {
-    uint64_t Value = getBinaryCodeForInstr(MI, Fixups, STI);
-    LE.write<uint8_t>(Value >> 56);
-    if (IsLittleEndian)
-      LE.write<uint8_t>((Value >> 48) & 0xff);
-    else
-      LE.write<uint8_t>(SwapBits((Value >> 48) & 0xff));
-    LE.write<uint16_t>(0);
-    if (IsLittleEndian)
-      LE.write<uint32_t>(Value & 0xffffFFFF);
-    else
-      BE.write<uint32_t>(Value & 0xffffFFFF);
-
-    const MCOperand &MO = MI.getOperand(1);
-    uint64_t Imm = MO.isImm() ? MO.getImm() : 0;
-    LE.write<uint8_t>(0);
-    LE.write<uint8_t>(0);
-    LE.write<uint16_t>(0);
-    if (IsLittleEndian)
-      LE.write<uint32_t>(Imm >> 32);
-    else
-      BE.write<uint32_t>(Imm >> 32);
-  } else {
-    // Get instruction encoding and emit it
-    uint64_t Value = getBinaryCodeForInstr(MI, Fixups, STI);
-    LE.write<uint8_t>(Value >> 56);
-    if (IsLittleEndian) {
-      LE.write<uint8_t>((Value >> 48) & 0xff);
-      LE.write<uint16_t>((Value >> 32) & 0xffff);
-      LE.write<uint32_t>(Value & 0xffffFFFF);
-    } else {
-      LE.write<uint8_t>(SwapBits((Value >> 48) & 0xff));
-      BE.write<uint16_t>((Value >> 32) & 0xffff);
-      BE.write<uint32_t>(Value & 0xffffFFFF);
-    }
+unsigned TNTMCCodeEmitter::getCCOpValue(const MCInst &MI, unsigned Op,
+                                        SmallVectorImpl<MCFixup> &Fixups,
+                                        const MCSubtargetInfo &STI) const {
+  const MCOperand &MO = MI.getOperand(Op);
+  assert(MO.isImm() && "Immediate operand expected");
+  switch (MO.getImm()) {
+  case TNTCC::COND_NE: return 0;
+  case TNTCC::COND_E:  return 1;
+  case TNTCC::COND_LO: return 2;
+  case TNTCC::COND_HS: return 3;
+  case TNTCC::COND_N:  return 4;
+  case TNTCC::COND_GE: return 5;
+  case TNTCC::COND_L:  return 6;
+  default:
+    llvm_unreachable("Unknown condition code");
   }
 }
 
-// Encode TNT Memory Operand
-uint64_t TNTMCCodeEmitter::getMemoryOpValue(const MCInst &MI, unsigned Op,
-                                            SmallVectorImpl<MCFixup> &Fixups,
-                                            const MCSubtargetInfo &STI) const {
-  uint64_t Encoding;
-  const MCOperand Op1 = MI.getOperand(1);
-  assert(Op1.isReg() && "First operand is not register.");
-  Encoding = MRI.getEncodingValue(Op1.getReg());
-  Encoding <<= 16;
-  MCOperand Op2 = MI.getOperand(2);
-  assert(Op2.isImm() && "Second operand is not immediate.");
-  Encoding |= Op2.getImm() & 0xffff;
-  return Encoding;
+unsigned TNTMCCodeEmitter::getCGImmOpValue(const MCInst &MI, unsigned Op,
+                                           SmallVectorImpl<MCFixup> &Fixups,
+                                           const MCSubtargetInfo &STI) const {
+  const MCOperand &MO = MI.getOperand(Op);
+  assert(MO.isImm() && "Immediate operand expected");
+  switch (MO.getImm()) {
+  case  0: return 0x03; // r3, As = 00
+  case  1: return 0x13; // r3, As = 01
+  case  2: return 0x23; // r3, As = 10
+  case -1: return 0x33; // r3, As = 11
+  case  4: return 0x22; // r2, As = 10
+  case  8: return 0x32; // r2, As = 11
+  default:
+    llvm_unreachable("Invalid constant generator value");
+  }
 }
 
 #include "TNTGenMCCodeEmitter.inc"
@@ -75,4 +75,11 @@ extern "C" void LLVMInitializeTNTTargetMC() {
   // Register the MCInstPrinter.
   TargetRegistry::RegisterMCInstPrinter(TheTNTTarget,
                                         createTNTMCInstPrinter);
+
+  // Register the MC code emitter.
+  TargetRegistry::RegisterMCCodeEmitter(TheTNTTarget,
+                                        createTNTMCCodeEmitter);
+
+  // Register the asm backend.
+  TargetRegistry::RegisterMCAsmBackend(TheTNTTarget, createTNTAsmBackend);
 }
@@ -17,10 +17,30 @@
 #include "llvm/Support/DataTypes.h"
 
 namespace llvm {
+class MCAsmBackend;
+class MCCodeEmitter;
+class MCContext;
+class MCInstrInfo;
+class MCObjectWriter;
+class MCRegisterInfo;
+class MCSubtargetInfo;
+class StringRef;
 class Target;
+class Triple;
+class raw_pwrite_stream;
 
 extern Target TheTNTTarget;
 
+MCCodeEmitter *createTNTMCCodeEmitter(const MCInstrInfo &MCII,
+                                      const MCRegisterInfo &MRI,
+                                      MCContext &Ctx);
+
+MCAsmBackend *createTNTAsmBackend(const Target &T, const MCRegisterInfo &MRI,
+                                  const Triple &TT, StringRef CPU);
+
+MCObjectWriter *createTNTELFObjectWriter(raw_pwrite_stream &OS,
+                                         uint8_t OSABI);
+
 } // End llvm namespace
 
 // Defines symbolic names for TNT registers.
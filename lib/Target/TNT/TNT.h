@@ -27,6 +27,7 @@ namespace TNTCC {
     COND_LO = 3,  // aka COND_NC
     COND_GE = 4,
     COND_L  = 5,
+    COND_N  = 6,  // jump if negative; not produced by codegen
 
     COND_INVALID = -1
   };
@@ -40,8 +41,6 @@ namespace llvm {
   FunctionPass *createTNTISelDag(TNTTargetMachine &TM,
                                     CodeGenOpt::Level OptLevel);
 
-  FunctionPass *createTNTBranchSelectionPass();
-
 } // end namespace llvm;
 
 #endif
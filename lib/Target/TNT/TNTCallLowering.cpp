@@ -0,0 +1,104 @@
+//===-- llvm/lib/Target/TNT/TNTCallLowering.cpp - Call lowering -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements the lowering of LLVM calls to machine code calls for
+/// GlobalISel.
+///
+//===----------------------------------------------------------------------===//
+
+#include "TNTCallLowering.h"
+#include "TNTISelLowering.h"
+#include "llvm/CodeGen/GlobalISel/MachineIRBuilder.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+
+using namespace llvm;
+
+#ifndef LLVM_BUILD_GLOBAL_ISEL
+#error "This shouldn't be built without GISel"
+#endif
+
+// Only the simple cases of the calling convention are handled so far: i8
+// and i16 values that fit in the argument registers. Wider values are split
+// and reordered by the SelectionDAG lowering (see AnalyzeArguments), which
+// still has to be ported.
+static bool isSupportedType(Type *Ty) {
+  return Ty->isIntegerTy(8) || Ty->isIntegerTy(16);
+}
+
+static bool isSupportedCallingConv(CallingConv::ID CC) {
+  return CC == CallingConv::C || CC == CallingConv::Fast;
+}
+
+/// Return the register holding the \p Ty-typed part of \p Reg.
+static unsigned getRegForType(unsigned Reg, Type *Ty) {
+  if (!Ty->isIntegerTy(8))
+    return Reg;
+  switch (Reg) {
+  default: llvm_unreachable("Unexpected argument register");
+  case TNT::R12: return TNT::R12B;
+  case TNT::R13: return TNT::R13B;
+  case TNT::R14: return TNT::R14B;
+  case TNT::R15: return TNT::R15B;
+  }
+}
+
+TNTCallLowering::TNTCallLowering(const TNTTargetLowering &TLI)
+  : CallLowering(&TLI) {
+}
+
+bool TNTCallLowering::lowerReturn(MachineIRBuilder &MIRBuilder,
+                                  const Value *Val, unsigned VReg) const {
+  MachineFunction &MF = MIRBuilder.getMF();
+  if (!isSupportedCallingConv(MF.getFunction()->getCallingConv()))
+    return false;
+  if (Val && !isSupportedType(Val->getType()))
+    return false;
+
+  MachineInstr *Return = MIRBuilder.buildInstr(TNT::RET);
+  assert(Return && "Unable to build a return instruction?!");
+
+  assert(((Val && VReg) || (!Val && !VReg)) && "Return value without a vreg");
+  if (VReg) {
+    unsigned ResReg = getRegForType(TNT::R15, Val->getType());
+    // Set the insertion point to be right before Return.
+    MIRBuilder.setInstr(*Return, /* Before */ true);
+    MIRBuilder.buildInstr(TargetOpcode::COPY, ResReg, VReg);
+    MachineInstrBuilder(MF, Return).addReg(ResReg, RegState::Implicit);
+  }
+  return true;
+}
+
+bool TNTCallLowering::lowerFormalArguments(
+    MachineIRBuilder &MIRBuilder, const Function::ArgumentListType &Args,
+    const SmallVectorImpl<unsigned> &VRegs) const {
+  static const MCPhysReg RegList[] = {
+    TNT::R15, TNT::R14, TNT::R13, TNT::R12
+  };
+
+  const Function &F = *MIRBuilder.getMF().getFunction();
+  if (!isSupportedCallingConv(F.getCallingConv()) || F.isVarArg() ||
+      Args.size() > array_lengthof(RegList))
+    return false;
+
+  unsigned Idx = 0;
+  for (const Argument &Arg : Args) {
+    if (!isSupportedType(Arg.getType()) || Arg.hasByValAttr())
+      return false;
+
+    // Transform the arguments in physical registers into virtual ones.
+    // i8 arguments are promoted to i16: only their low part is meaningful.
+    MIRBuilder.getMBB().addLiveIn(RegList[Idx]);
+    MIRBuilder.buildInstr(TargetOpcode::COPY, VRegs[Idx],
+                          getRegForType(RegList[Idx], Arg.getType()));
+    ++Idx;
+  }
+  return true;
+}
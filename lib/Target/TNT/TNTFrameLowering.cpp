@@ -29,18 +29,38 @@ using namespace llvm;
 bool TNTFrameLowering::hasFP(const MachineFunction &MF) const {
   const MachineFrameInfo *MFI = MF.getFrameInfo();
 
-  return (MF.getTarget().Options.DisableFramePointerElim(MF) ||
-          MF.getFrameInfo()->hasVarSizedObjects() ||
-          MFI->isFrameAddressTaken());
+  if (MFI->hasVarSizedObjects() || MFI->isFrameAddressTaken())
+    return true;
+
+  // Leaf interrupt handlers are latency critical and never need a frame
+  // pointer for unwinding, so they do without one even when asked not to
+  // eliminate it.
+  if (MF.getFunction()->getCallingConv() == CallingConv::MSP430_INTR &&
+      !MFI->hasCalls())
+    return false;
+
+  return MF.getTarget().Options.DisableFramePointerElim(MF);
 }
 
 bool TNTFrameLowering::hasReservedCallFrame(const MachineFunction &MF) const {
   return !MF.getFrameInfo()->hasVarSizedObjects();
 }
 
+// The stack pointer adjustments in the prologue and epilogue clobber the
+// flags, so they cannot go where the flags are live.
+bool TNTFrameLowering::canUseAsPrologue(const MachineBasicBlock &MBB) const {
+  return !MBB.isLiveIn(TNT::SR);
+}
+
+bool TNTFrameLowering::canUseAsEpilogue(const MachineBasicBlock &MBB) const {
+  for (const MachineInstr &MI : MBB.terminators())
+    if (MI.readsRegister(TNT::SR))
+      return false;
+  return true;
+}
+
 void TNTFrameLowering::emitPrologue(MachineFunction &MF,
                                        MachineBasicBlock &MBB) const {
-  assert(&MF.front() == &MBB && "Shrink-wrapping not yet supported");
   MachineFrameInfo *MFI = MF.getFrameInfo();
   TNTMachineFunctionInfo *TNTFI = MF.getInfo<TNTMachineFunctionInfo>();
   const TNTInstrInfo &TII =
@@ -71,16 +91,19 @@ void TNTFrameLowering::emitPrologue(MachineFunction &MF,
     BuildMI(MBB, MBBI, DL, TII.get(TNT::MOV16rr), TNT::FP)
       .addReg(TNT::SP);
 
-    // Mark the FramePtr as live-in in every block except the entry.
-    for (MachineFunction::iterator I = std::next(MF.begin()), E = MF.end();
-         I != E; ++I)
-      I->addLiveIn(TNT::FP);
+    // Mark the FramePtr as live-in in every block except the one holding the
+    // prologue.
+    for (MachineBasicBlock &OtherMBB : MF)
+      if (&OtherMBB != &MBB)
+        OtherMBB.addLiveIn(TNT::FP);
 
   } else
     NumBytes = StackSize - TNTFI->getCalleeSavedFrameSize();
 
-  // Skip the callee-saved push instructions.
-  while (MBBI != MBB.end() && (MBBI->getOpcode() == TNT::PUSH16r))
+  // Skip the callee-saved push instructions. Count them rather than matching
+  // opcodes: the block may go on to push outgoing call arguments.
+  for (unsigned i = 0, e = MFI->getCalleeSavedInfo().size();
+       i != e && MBBI != MBB.end() && MBBI->getOpcode() == TNT::PUSH16r; ++i)
     ++MBBI;
 
   if (MBBI != MBB.end())
@@ -111,16 +134,10 @@ void TNTFrameLowering::emitEpilogue(MachineFunction &MF,
   const TNTInstrInfo &TII =
       *static_cast<const TNTInstrInfo *>(MF.getSubtarget().getInstrInfo());
 
-  MachineBasicBlock::iterator MBBI = MBB.getLastNonDebugInstr();
-  unsigned RetOpcode = MBBI->getOpcode();
-  DebugLoc DL = MBBI->getDebugLoc();
-
-  switch (RetOpcode) {
-  case TNT::RET:
-  case TNT::RETI: break;  // These are ok
-  default:
-    llvm_unreachable("Can only insert epilog into returning blocks");
-  }
+  // With shrink-wrapping the epilogue block need not return; the epilogue
+  // goes before its terminators either way.
+  MachineBasicBlock::iterator MBBI = MBB.getFirstTerminator();
+  DebugLoc DL = MBBI != MBB.end() ? MBBI->getDebugLoc() : DebugLoc();
 
   // Get the number of bytes to allocate from the FrameInfo
   uint64_t StackSize = MFI->getStackSize();
@@ -137,16 +154,11 @@ void TNTFrameLowering::emitEpilogue(MachineFunction &MF,
   } else
     NumBytes = StackSize - CSSize;
 
-  // Skip the callee-saved pop instructions.
-  while (MBBI != MBB.begin()) {
-    MachineBasicBlock::iterator PI = std::prev(MBBI);
-    unsigned Opc = PI->getOpcode();
-    if (Opc != TNT::POP16r && !PI->isTerminator())
-      break;
+  // Skip the callee-saved pop instructions, and the pop of FP after them.
+  for (unsigned i = 0, e = MFI->getCalleeSavedInfo().size() + hasFP(MF);
+       i != e && MBBI != MBB.begin() &&
+       std::prev(MBBI)->getOpcode() == TNT::POP16r; ++i)
     --MBBI;
-  }
-
-  DL = MBBI->getDebugLoc();
 
   // If there is an ADD16ri or SUB16ri of SP immediately before this
   // instruction, merge the two instructions.
@@ -43,6 +43,14 @@ public:
                                   const std::vector<CalleeSavedInfo> &CSI,
                                   const TargetRegisterInfo *TRI) const override;
 
+  /// The prologue and epilogue may be placed around the blocks that need a
+  /// frame rather than at function entry and exit.
+  bool enableShrinkWrapping(const MachineFunction &MF) const override {
+    return true;
+  }
+  bool canUseAsPrologue(const MachineBasicBlock &MBB) const override;
+  bool canUseAsEpilogue(const MachineBasicBlock &MBB) const override;
+
   bool hasFP(const MachineFunction &MF) const override;
   bool hasReservedCallFrame(const MachineFunction &MF) const override;
   void processFunctionBeforeFrameFinalized(MachineFunction &MF,
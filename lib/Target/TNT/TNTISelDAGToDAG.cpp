@@ -112,6 +112,7 @@ namespace {
   private:
     void Select(SDNode *N) override;
     bool tryIndexedLoad(SDNode *Op);
+    bool tryIndexedStore(SDNode *Op);
     bool tryIndexedBinOp(SDNode *Op, SDValue N1, SDValue N2, unsigned Opc8,
                          unsigned Opc16);
 
@@ -348,6 +349,41 @@ bool TNTDAGToDAGISel::tryIndexedLoad(SDNode *N) {
   return true;
 }
 
+/// tryIndexedStore - Fold a post-incremented load whose only use is a store
+/// into a single memory to memory move.
+bool TNTDAGToDAGISel::tryIndexedStore(SDNode *N) {
+  StoreSDNode *ST = cast<StoreSDNode>(N);
+  SDValue N1 = ST->getValue();
+  if (!ST->isUnindexed() || ST->isTruncatingStore() ||
+      N1.getOpcode() != ISD::LOAD || N1.getResNo() != 0 || !N1.hasOneUse())
+    return false;
+
+  LoadSDNode *LD = cast<LoadSDNode>(N1);
+  if (!isValidIndexedLoad(LD) || ST->getChain() != SDValue(LD, 2) ||
+      !IsLegalToFold(N1, N, N, OptLevel))
+    return false;
+
+  SDValue Base, Disp;
+  if (!SelectAddr(ST->getBasePtr(), Base, Disp))
+    return false;
+
+  MVT VT = LD->getMemoryVT().getSimpleVT();
+  unsigned Opc = (VT == MVT::i16 ? TNT::MOV16mm_POST : TNT::MOV8mm_POST);
+  MachineSDNode::mmo_iterator MemRefs = MF->allocateMemRefsArray(2);
+  MemRefs[0] = LD->getMemOperand();
+  MemRefs[1] = ST->getMemOperand();
+  SDValue Ops[] = { Base, Disp, LD->getBasePtr(), LD->getChain() };
+  MachineSDNode *ResNode =
+    CurDAG->getMachineNode(Opc, SDLoc(N), MVT::i16, MVT::Other, Ops);
+  ResNode->setMemRefs(MemRefs, MemRefs + 2);
+  // Transfer writeback and chain of the load, and chain of the store.
+  ReplaceUses(SDValue(LD, 1), SDValue(ResNode, 0));
+  ReplaceUses(SDValue(LD, 2), SDValue(ResNode, 1));
+  ReplaceUses(SDValue(N, 0), SDValue(ResNode, 1));
+  CurDAG->RemoveDeadNode(N);
+  return true;
+}
+
 bool TNTDAGToDAGISel::tryIndexedBinOp(SDNode *Op, SDValue N1, SDValue N2,
                                          unsigned Opc8, unsigned Opc16) {
   if (N1.getOpcode() == ISD::LOAD &&
@@ -415,6 +451,11 @@ void TNTDAGToDAGISel::Select(SDNode *Node) {
       return;
     // Other cases are autogenerated.
     break;
+  case ISD::STORE:
+    if (tryIndexedStore(Node))
+      return;
+    // Other cases are autogenerated.
+    break;
   case ISD::ADD:
     if (tryIndexedBinOp(Node, Node->getOperand(0), Node->getOperand(1),
                         TNT::ADD8rm_POST, TNT::ADD16rm_POST))
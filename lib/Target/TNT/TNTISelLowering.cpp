@@ -20,6 +20,7 @@
 #include "llvm/CodeGen/MachineFrameInfo.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineJumpTableInfo.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
 #include "llvm/CodeGen/SelectionDAGISel.h"
 #include "llvm/CodeGen/TargetLoweringObjectFileImpl.h"
@@ -101,7 +102,7 @@ TNTTargetLowering::TNTTargetLowering(const TargetMachine &TM,
   setOperationAction(ISD::GlobalAddress,    MVT::i16,   Custom);
   setOperationAction(ISD::ExternalSymbol,   MVT::i16,   Custom);
   setOperationAction(ISD::BlockAddress,     MVT::i16,   Custom);
-  setOperationAction(ISD::BR_JT,            MVT::Other, Expand);
+  setOperationAction(ISD::BR_JT,            MVT::Other, Custom);
   setOperationAction(ISD::BR_CC,            MVT::i8,    Custom);
   setOperationAction(ISD::BR_CC,            MVT::i16,   Custom);
   setOperationAction(ISD::BRCOND,           MVT::Other, Expand);
@@ -131,15 +132,22 @@ TNTTargetLowering::TNTTargetLowering(const TargetMachine &TM,
 
   setOperationAction(ISD::SIGN_EXTEND_INREG, MVT::i1,   Expand);
 
-  // FIXME: Implement efficiently multiplication by a constant
-  setOperationAction(ISD::MUL,              MVT::i8,    Expand);
+  // Multiplication by a constant is turned into shifts and adds by
+  // PerformDAGCombine. The hardware multiplier is used inline only if
+  // interrupt handlers promise not to touch it; otherwise the runtime
+  // library is responsible for guarding it. Interrupt handlers keep that
+  // promise by multiplying in software.
+  bool InlineHWMult = HWMultMode == HWMultNoIntr && !STI.isForInterrupts();
+  LegalizeAction MulAction =
+      STI.hasHWMult() && InlineHWMult ? Legal : Expand;
+  setOperationAction(ISD::MUL,              MVT::i8,    MulAction);
   setOperationAction(ISD::MULHS,            MVT::i8,    Expand);
   setOperationAction(ISD::MULHU,            MVT::i8,    Expand);
   setOperationAction(ISD::SMUL_LOHI,        MVT::i8,    Expand);
   setOperationAction(ISD::UMUL_LOHI,        MVT::i8,    Expand);
-  setOperationAction(ISD::MUL,              MVT::i16,   Expand);
-  setOperationAction(ISD::MULHS,            MVT::i16,   Expand);
-  setOperationAction(ISD::MULHU,            MVT::i16,   Expand);
+  setOperationAction(ISD::MUL,              MVT::i16,   MulAction);
+  setOperationAction(ISD::MULHS,            MVT::i16,   MulAction);
+  setOperationAction(ISD::MULHU,            MVT::i16,   MulAction);
   setOperationAction(ISD::SMUL_LOHI,        MVT::i16,   Expand);
   setOperationAction(ISD::UMUL_LOHI,        MVT::i16,   Expand);
 
@@ -163,11 +171,15 @@ TNTTargetLowering::TNTTargetLowering(const TargetMachine &TM,
   setOperationAction(ISD::VACOPY,           MVT::Other, Expand);
   setOperationAction(ISD::JumpTable,        MVT::i16,   Custom);
 
+  setTargetDAGCombine(ISD::MUL);
+  setTargetDAGCombine(ISD::SDIV);
+  setTargetDAGCombine(ISD::UDIV);
+
   // Libcalls names.
   if (HWMultMode == HWMultIntr) {
     setLibcallName(RTLIB::MUL_I8,  "__mulqi3hw");
     setLibcallName(RTLIB::MUL_I16, "__mulhi3hw");
-  } else if (HWMultMode == HWMultNoIntr) {
+  } else if (InlineHWMult) {
     setLibcallName(RTLIB::MUL_I8,  "__mulqi3hw_noint");
     setLibcallName(RTLIB::MUL_I16, "__mulhi3hw_noint");
   }
@@ -193,6 +205,7 @@ SDValue TNTTargetLowering::LowerOperation(SDValue Op,
   case ISD::FRAMEADDR:        return LowerFRAMEADDR(Op, DAG);
   case ISD::VASTART:          return LowerVASTART(Op, DAG);
   case ISD::JumpTable:        return LowerJumpTable(Op, DAG);
+  case ISD::BR_JT:            return LowerBR_JT(Op, DAG);
   default:
     llvm_unreachable("unimplemented operand");
   }
@@ -369,10 +382,10 @@ SDValue TNTTargetLowering::LowerFormalArguments(
   case CallingConv::C:
   case CallingConv::Fast:
     return LowerCCCArguments(Chain, CallConv, isVarArg, Ins, dl, DAG, InVals);
-  //case CallingConv::TNT_INTR:
-  //  if (Ins.empty())
-  //    return Chain;
-  //  report_fatal_error("ISRs cannot have arguments");
+  case CallingConv::MSP430_INTR:
+    if (Ins.empty())
+      return Chain;
+    report_fatal_error("ISRs cannot have arguments");
   }
 }
 
@@ -400,8 +413,8 @@ TNTTargetLowering::LowerCall(TargetLowering::CallLoweringInfo &CLI,
   case CallingConv::C:
     return LowerCCCCallTo(Chain, Callee, CallConv, isVarArg, isTailCall,
                           Outs, OutVals, Ins, dl, DAG, InVals);
-  //case CallingConv::TNT_INTR:
-  //  report_fatal_error("ISRs cannot be called directly");
+  case CallingConv::MSP430_INTR:
+    report_fatal_error("ISRs cannot be called directly");
   }
 }
 
@@ -491,6 +504,17 @@ SDValue TNTTargetLowering::LowerCCCArguments(
         InVal = DAG.getLoad(
             VA.getLocVT(), dl, Chain, FIN,
             MachinePointerInfo::getFixedStack(DAG.getMachineFunction(), FI));
+
+        // 8-bit values are promoted to a full stack slot as well.
+        if (VA.getLocInfo() == CCValAssign::SExt)
+          InVal = DAG.getNode(ISD::AssertSext, dl, VA.getLocVT(), InVal,
+                              DAG.getValueType(VA.getValVT()));
+        else if (VA.getLocInfo() == CCValAssign::ZExt)
+          InVal = DAG.getNode(ISD::AssertZext, dl, VA.getLocVT(), InVal,
+                              DAG.getValueType(VA.getValVT()));
+
+        if (VA.getLocInfo() != CCValAssign::Full)
+          InVal = DAG.getNode(ISD::TRUNCATE, dl, VA.getValVT(), InVal);
       }
 
       InVals.push_back(InVal);
@@ -511,8 +535,8 @@ TNTTargetLowering::LowerReturn(SDValue Chain, CallingConv::ID CallConv,
   SmallVector<CCValAssign, 16> RVLocs;
 
   // ISRs cannot return any value.
-  //if (CallConv == CallingConv::TNT_INTR && !Outs.empty())
-  //  report_fatal_error("ISRs cannot return any value");
+  if (CallConv == CallingConv::MSP430_INTR && !Outs.empty())
+    report_fatal_error("ISRs cannot return any value");
 
   // CCState - Info about the registers and stack slot.
   CCState CCInfo(CallConv, isVarArg, DAG.getMachineFunction(), RVLocs,
@@ -538,10 +562,8 @@ TNTTargetLowering::LowerReturn(SDValue Chain, CallingConv::ID CallConv,
     RetOps.push_back(DAG.getRegister(VA.getLocReg(), VA.getLocVT()));
   }
 
-  // TODO: XXX
-  unsigned Opc = TNTISD::RET_FLAG;
-  //unsigned Opc = (CallConv == CallingConv::TNT_INTR ?
-  //                TNTISD::RETI_FLAG : TNTISD::RET_FLAG);
+  unsigned Opc = (CallConv == CallingConv::MSP430_INTR ?
+                  TNTISD::RETI_FLAG : TNTISD::RET_FLAG);
 
   RetOps[0] = Chain;  // Update chain.
 
@@ -668,6 +690,15 @@ SDValue TNTTargetLowering::LowerCCCCallTo(
     Ops.push_back(DAG.getRegister(RegsToPass[i].first,
                                   RegsToPass[i].second.getValueType()));
 
+  // Add a register mask operand representing the call-preserved registers.
+  // With interprocedural register allocation it is later narrowed to what
+  // the callee actually clobbers.
+  const TargetRegisterInfo *TRI = DAG.getSubtarget().getRegisterInfo();
+  const uint32_t *Mask =
+      TRI->getCallPreservedMask(DAG.getMachineFunction(), CallConv);
+  assert(Mask && "Missing call preserved mask for calling convention");
+  Ops.push_back(DAG.getRegisterMask(Mask));
+
   if (InFlag.getNode())
     Ops.push_back(InFlag);
 
@@ -736,10 +767,38 @@ SDValue TNTTargetLowering::LowerShifts(SDValue Op,
   uint64_t ShiftAmount = cast<ConstantSDNode>(N->getOperand(1))->getZExtValue();
 
   // Expand the stuff into sequence of shifts.
-  // FIXME: for some shift amounts this might be done better!
-  // E.g.: foo >> (8 + N) => sxt(swpb(foo)) >> N
   SDValue Victim = N->getOperand(0);
 
+  // Shifting a word by 8 or more moves whole bytes: swap them and extend,
+  // then shift the rest of the way.
+  //   foo <<  (8 + N) => swpb(zext(foo)) << N
+  //   foo >>u (8 + N) => zext(swpb(foo)) >> N
+  //   foo >>s (8 + N) => sxt(swpb(foo)) >> N
+  // The upper bits already hold the sign or zero afterwards, so right
+  // shifts can continue with rra.
+  if (VT == MVT::i16 && ShiftAmount >= 8) {
+    switch (Opc) {
+    default: llvm_unreachable("Invalid shift opcode!");
+    case ISD::SHL:
+      Victim = DAG.getNode(ISD::AND, dl, VT, Victim,
+                           DAG.getConstant(0xff, dl, VT));
+      Victim = DAG.getNode(ISD::BSWAP, dl, VT, Victim);
+      break;
+    case ISD::SRL:
+      Victim = DAG.getNode(ISD::BSWAP, dl, VT, Victim);
+      Victim = DAG.getNode(ISD::AND, dl, VT, Victim,
+                           DAG.getConstant(0xff, dl, VT));
+      Opc = ISD::SRA;
+      break;
+    case ISD::SRA:
+      Victim = DAG.getNode(ISD::BSWAP, dl, VT, Victim);
+      Victim = DAG.getNode(ISD::SIGN_EXTEND_INREG, dl, VT, Victim,
+                           DAG.getValueType(MVT::i8));
+      break;
+    }
+    ShiftAmount -= 8;
+  }
+
   if (Opc == ISD::SRL && ShiftAmount) {
     // Emit a special goodness here:
     // srl A, 1 => clrc; rrc A
@@ -1074,6 +1133,27 @@ SDValue TNTTargetLowering::LowerJumpTable(SDValue Op,
     return DAG.getNode(TNTISD::Wrapper, SDLoc(JT), PtrVT, Result);
 }
 
+/// LowerBR_JT - Branch through a table of 16-bit block addresses with
+/// "br .LJTI(Rn)". The generic expansion scales the index with a multiply,
+/// which is a library call here.
+SDValue TNTTargetLowering::LowerBR_JT(SDValue Op, SelectionDAG &DAG) const {
+  SDValue Chain = Op.getOperand(0);
+  SDValue Table = Op.getOperand(1);
+  SDValue Index = Op.getOperand(2);
+  SDLoc dl(Op);
+  auto PtrVT = getPointerTy(DAG.getDataLayout());
+
+  assert(getJumpTableEncoding() == MachineJumpTableInfo::EK_BlockAddress &&
+         "Jump table entries are not block addresses!");
+  Index = DAG.getNode(ISD::SHL, dl, PtrVT, Index,
+                      DAG.getConstant(1, dl, PtrVT));
+  SDValue Addr = DAG.getNode(ISD::ADD, dl, PtrVT, Table, Index);
+  SDValue Target =
+      DAG.getLoad(PtrVT, dl, Chain, Addr,
+                  MachinePointerInfo::getJumpTable(DAG.getMachineFunction()));
+  return DAG.getNode(ISD::BRIND, dl, MVT::Other, Target.getValue(1), Target);
+}
+
 /// getPostIndexedAddressParts - returns true by value, base pointer and
 /// offset pointer and addressing mode by reference if this node can be
 /// combined with a load / store to form a post-indexed load / store.
@@ -1110,6 +1190,230 @@ bool TNTTargetLowering::getPostIndexedAddressParts(SDNode *N, SDNode *Op,
 }
 
 
+//===----------------------------------------------------------------------===//
+//                Multiplication and Division by Constants
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// One term of a multiplier in non-adjacent form, i.e. written as a sum of
+/// signed powers of two no two of which are adjacent.
+struct NAFTerm {
+  unsigned Shift;
+  bool Negative;
+};
+} // end anonymous namespace
+
+/// getNAFTerms - Decompose the low Bits bits of C into non-adjacent form.
+/// This minimizes the number of additions needed to multiply by C; terms
+/// shifted out of the result are dropped.
+static void getNAFTerms(uint64_t C, unsigned Bits,
+                        SmallVectorImpl<NAFTerm> &Terms) {
+  for (unsigned Shift = 0; C && Shift < Bits; ++Shift, C >>= 1) {
+    if (!(C & 1))
+      continue;
+    bool Negative = (C & 3) == 3;
+    Terms.push_back({Shift, Negative});
+    C = Negative ? C + 1 : C - 1;
+  }
+}
+
+/// Number of 16-bit registers a value of type VT occupies.
+static unsigned getNumWords(EVT VT) {
+  return (VT.getSizeInBits() + 15) / 16;
+}
+
+/// getShiftAddCost - Return the number of single-word instructions needed
+/// to multiply a value of type VT by Terms. Shifts are done by doubling, so
+/// every term reuses the previous one.
+static unsigned getShiftAddCost(ArrayRef<NAFTerm> Terms, EVT VT) {
+  if (Terms.empty())
+    return 0;
+
+  unsigned Cost = Terms.back().Shift + Terms.size() - 1;
+  // Without a positive term the result has to be negated.
+  if (std::all_of(Terms.begin(), Terms.end(),
+                  [](const NAFTerm &T) { return T.Negative; }))
+    ++Cost;
+  return Cost * getNumWords(VT);
+}
+
+static SDValue buildShiftAdd(SDValue X, ArrayRef<NAFTerm> Terms,
+                             const SDLoc &dl, SelectionDAG &DAG) {
+  EVT VT = X.getValueType();
+  SDValue Pos, Neg;
+  unsigned Shift = 0;
+  for (const NAFTerm &T : Terms) {
+    // X + X rather than X << 1: expanded wide types then need no real
+    // shifts, and constant shifts are unrolled anyway.
+    for (; Shift < T.Shift; ++Shift)
+      X = DAG.getNode(ISD::ADD, dl, VT, X, X);
+    SDValue &Acc = T.Negative ? Neg : Pos;
+    Acc = Acc.getNode() ? DAG.getNode(ISD::ADD, dl, VT, Acc, X) : X;
+  }
+
+  if (!Neg.getNode())
+    return Pos;
+  if (!Pos.getNode())
+    Pos = DAG.getConstant(0, dl, VT);
+  return DAG.getNode(ISD::SUB, dl, VT, Pos, Neg);
+}
+
+/// getMulBudget - Return how many single-word instructions a shift / add
+/// sequence may take and still beat a real multiplication of type VT.
+static unsigned getMulBudget(EVT VT, SelectionDAG &DAG,
+                             const TargetLowering &TLI) {
+  unsigned Words = getNumWords(VT);
+  // An inline hardware multiply is three moves per 16-bit partial product.
+  if (TLI.isOperationLegal(ISD::MUL, MVT::i16))
+    return 3 * Words * Words;
+  // Otherwise it is a libcall. Its loop is slow, but the call is small.
+  if (DAG.getMachineFunction().getFunction()->optForSize())
+    return 3;
+  return 16 * Words;
+}
+
+static SDValue PerformMULCombine(SDNode *N,
+                                 TargetLowering::DAGCombinerInfo &DCI,
+                                 const TargetLowering &TLI) {
+  SelectionDAG &DAG = DCI.DAG;
+  EVT VT = N->getValueType(0);
+  ConstantSDNode *C = dyn_cast<ConstantSDNode>(N->getOperand(1));
+  if (!C || !VT.isSimple() || VT.getSizeInBits() > 32)
+    return SDValue();
+
+  SmallVector<NAFTerm, 8> Terms;
+  getNAFTerms(C->getZExtValue(), VT.getSizeInBits(), Terms);
+  if (getShiftAddCost(Terms, VT) > getMulBudget(VT, DAG, TLI))
+    return SDValue();
+
+  return buildShiftAdd(N->getOperand(0), Terms, SDLoc(N), DAG);
+}
+
+/// PerformDIVCombine - Without a multiplier the generic combine leaves
+/// division by a constant to a libcall. Divide by multiplying with the
+/// magic reciprocal instead, computing the high half of the product with
+/// shifts and adds in the double width type.
+static SDValue PerformDIVCombine(SDNode *N,
+                                 TargetLowering::DAGCombinerInfo &DCI,
+                                 const TargetLowering &TLI) {
+  SelectionDAG &DAG = DCI.DAG;
+  EVT VT = N->getValueType(0);
+  bool IsSigned = N->getOpcode() == ISD::SDIV;
+  ConstantSDNode *C = dyn_cast<ConstantSDNode>(N->getOperand(1));
+  if (!C || !DCI.isBeforeLegalize() || (VT != MVT::i8 && VT != MVT::i16) ||
+      TLI.isOperationLegalOrCustom(IsSigned ? ISD::MULHS : ISD::MULHU, VT))
+    return SDValue();
+
+  if (DAG.getMachineFunction().getFunction()->optForSize())
+    return SDValue();
+
+  // Powers of two are left to the generic combine.
+  const APInt &D = C->getAPIntValue();
+  if (!D || (IsSigned ? D.abs() : D).isPowerOf2())
+    return SDValue();
+
+  SDLoc dl(N);
+  unsigned Bits = VT.getSizeInBits();
+
+  // Byte division can use the word sized multiplier, if there is one.
+  if (VT == MVT::i8 &&
+      TLI.isOperationLegal(IsSigned ? ISD::MULHS : ISD::MULHU, MVT::i16)) {
+    unsigned ExtOpc = IsSigned ? ISD::SIGN_EXTEND : ISD::ZERO_EXTEND;
+    SDValue Div = DAG.getNode(N->getOpcode(), dl, MVT::i16,
+                              DAG.getNode(ExtOpc, dl, MVT::i16,
+                                          N->getOperand(0)),
+                              DAG.getNode(ExtOpc, dl, MVT::i16,
+                                          N->getOperand(1)));
+    return DAG.getNode(ISD::TRUNCATE, dl, VT, Div);
+  }
+
+  EVT WideVT = EVT::getIntegerVT(*DAG.getContext(), 2 * Bits);
+  EVT ShTy = TLI.getShiftAmountTy(VT, DAG.getDataLayout());
+  auto getShiftAmount = [&](unsigned Amt) {
+    return DAG.getConstant(Amt, dl, ShTy);
+  };
+
+  SDValue X = N->getOperand(0);
+  SDValue Q = X;
+  APInt M;
+  unsigned S;
+  bool NeedsFixup;
+  // Constant shifts are unrolled, so count every bit of them.
+  unsigned Cost;
+  if (IsSigned) {
+    APInt::ms Magics = D.magic();
+    M = Magics.m;
+    S = Magics.s;
+    NeedsFixup = (D.isStrictlyPositive() && M.isNegative()) ||
+                 (D.isNegative() && M.isStrictlyPositive());
+    Cost = NeedsFixup + S + (Bits - 1) + 1;
+  } else {
+    APInt::mu Magics = D.magicu();
+    unsigned PreShift = 0;
+    // An even divisor can avoid the expensive fixup by shifting first.
+    if (Magics.a && !D[0]) {
+      PreShift = D.countTrailingZeros();
+      Q = DAG.getNode(ISD::SRL, dl, VT, Q, getShiftAmount(PreShift));
+      Magics = D.lshr(PreShift).magicu(PreShift);
+    }
+    M = Magics.m;
+    S = Magics.s;
+    NeedsFixup = Magics.a;
+    Cost = PreShift + (NeedsFixup ? 3 + (S - 1) : S);
+  }
+
+  SmallVector<NAFTerm, 8> Terms;
+  APInt WideM = IsSigned ? M.sext(2 * Bits) : M.zext(2 * Bits);
+  getNAFTerms(WideM.getZExtValue(), 2 * Bits, Terms);
+  Cost += getShiftAddCost(Terms, WideVT);
+  // Taking the high half is free once the wide type has been expanded.
+  if (TLI.isTypeLegal(WideVT))
+    Cost += Bits;
+  if (Cost > 3 * Bits)
+    return SDValue();
+
+  // Q = mulh(Q, M)
+  Q = DAG.getNode(IsSigned ? ISD::SIGN_EXTEND : ISD::ZERO_EXTEND, dl, WideVT,
+                  Q);
+  Q = buildShiftAdd(Q, Terms, dl, DAG);
+  Q = DAG.getNode(ISD::SRL, dl, WideVT, Q,
+                  DAG.getConstant(Bits, dl,
+                                  TLI.getShiftAmountTy(WideVT,
+                                                       DAG.getDataLayout())));
+  Q = DAG.getNode(ISD::TRUNCATE, dl, VT, Q);
+
+  if (IsSigned) {
+    if (NeedsFixup)
+      Q = DAG.getNode(D.isNegative() ? ISD::SUB : ISD::ADD, dl, VT, Q, X);
+    if (S)
+      Q = DAG.getNode(ISD::SRA, dl, VT, Q, getShiftAmount(S));
+    // Round towards zero by adding one to negative quotients.
+    SDValue T = DAG.getNode(ISD::SRL, dl, VT, Q, getShiftAmount(Bits - 1));
+    return DAG.getNode(ISD::ADD, dl, VT, Q, T);
+  }
+
+  if (!NeedsFixup)
+    return DAG.getNode(ISD::SRL, dl, VT, Q, getShiftAmount(S));
+
+  SDValue NPQ = DAG.getNode(ISD::SUB, dl, VT, X, Q);
+  NPQ = DAG.getNode(ISD::SRL, dl, VT, NPQ, getShiftAmount(1));
+  NPQ = DAG.getNode(ISD::ADD, dl, VT, NPQ, Q);
+  return DAG.getNode(ISD::SRL, dl, VT, NPQ, getShiftAmount(S - 1));
+}
+
+SDValue TNTTargetLowering::PerformDAGCombine(SDNode *N,
+                                             DAGCombinerInfo &DCI) const {
+  switch (N->getOpcode()) {
+  default: break;
+  case ISD::MUL:  return PerformMULCombine(N, DCI, *this);
+  case ISD::SDIV:
+  case ISD::UDIV: return PerformDIVCombine(N, DCI, *this);
+  }
+
+  return SDValue();
+}
+
+
 const char *TNTTargetLowering::getTargetNodeName(unsigned Opcode) const {
   switch ((TNTISD::NodeType)Opcode) {
   case TNTISD::FIRST_NUMBER:       break;
@@ -1131,6 +1435,21 @@ const char *TNTTargetLowering::getTargetNodeName(unsigned Opcode) const {
   return nullptr;
 }
 
+bool TNTTargetLowering::isLegalAddressingMode(const DataLayout &DL,
+                                              const AddrMode &AM, Type *Ty,
+                                              unsigned AS) const {
+  // X(Rn), &X, sym(Rn) and @Rn all take a single register or symbol plus a
+  // 16-bit index; there is no register + register form.
+  switch (AM.Scale) {
+  case 0:
+    return true;
+  case 1:
+    return !AM.HasBaseReg;
+  default:
+    return false;
+  }
+}
+
 bool TNTTargetLowering::isTruncateFree(Type *Ty1,
                                           Type *Ty2) const {
   if (!Ty1->isIntegerTy() || !Ty2->isIntegerTy())
@@ -1164,6 +1483,43 @@ bool TNTTargetLowering::isZExtFree(SDValue Val, EVT VT2) const {
 //  Other Lowering Code
 //===----------------------------------------------------------------------===//
 
+/// emitShiftBy - Emit the instructions shifting SrcReg by the constant
+/// Amount at the end of MBB, returning the register holding the result.
+static unsigned emitShiftBy(MachineBasicBlock *MBB, const DebugLoc &dl,
+                            const TargetInstrInfo &TII,
+                            MachineRegisterInfo &RI, unsigned ShiftOpc,
+                            const TargetRegisterClass *RC, unsigned SrcReg,
+                            unsigned Amount) {
+  unsigned Reg = SrcReg;
+  auto emit = [&](unsigned Opc) {
+    unsigned NewReg = RI.createVirtualRegister(RC);
+    BuildMI(MBB, dl, TII.get(Opc), NewReg).addReg(Reg);
+    Reg = NewReg;
+  };
+
+  // Move whole bytes of a word with swpb, as LowerShifts does.
+  if (Amount == 8 && RC == &TNT::GR16RegClass) {
+    switch (ShiftOpc) {
+    default: llvm_unreachable("Invalid shift opcode!");
+    case TNT::SHL16r1:  emit(TNT::ZEXT16r); emit(TNT::SWPB16r); break;
+    case TNT::SAR16r1:  emit(TNT::SWPB16r); emit(TNT::SEXT16r); break;
+    case TNT::SAR16r1c: emit(TNT::SWPB16r); emit(TNT::ZEXT16r); break;
+    }
+    return Reg;
+  }
+
+  // Only the first step of a logical right shift needs to clear the carry:
+  // the top bit is zero after it.
+  emit(ShiftOpc);
+  if (ShiftOpc == TNT::SAR8r1c)
+    ShiftOpc = TNT::SAR8r1;
+  else if (ShiftOpc == TNT::SAR16r1c)
+    ShiftOpc = TNT::SAR16r1;
+  while (--Amount)
+    emit(ShiftOpc);
+  return Reg;
+}
+
 MachineBasicBlock *
 TNTTargetLowering::EmitShiftInstr(MachineInstr &MI,
                                      MachineBasicBlock *BB) const {
@@ -1205,11 +1561,24 @@ TNTTargetLowering::EmitShiftInstr(MachineInstr &MI,
   const BasicBlock *LLVM_BB = BB->getBasicBlock();
   MachineFunction::iterator I = ++BB->getIterator();
 
-  // Create loop block
-  MachineBasicBlock *LoopBB = F->CreateMachineBasicBlock(LLVM_BB);
-  MachineBasicBlock *RemBB  = F->CreateMachineBasicBlock(LLVM_BB);
+  unsigned ShiftAmtReg = MI.getOperand(2).getReg();
+  unsigned SrcReg = MI.getOperand(1).getReg();
+  unsigned DstReg = MI.getOperand(0).getReg();
 
-  F->insert(I, LoopBB);
+  // Rather than looping once per bit, shift by each power of two present in
+  // the amount, largest first. Amounts of the bit width or more are
+  // undefined, so only log2(width) bits of it matter:
+  //
+  // BB:
+  //   bit #8, N
+  //   jeq NextBB
+  // StageBB:
+  //   ShiftReg2 = shift ShiftReg, 8
+  // NextBB:
+  //   ShiftReg3 = phi [%ShiftReg, BB], [%ShiftReg2, StageBB]
+  //   bit #4, N
+  //   ...
+  MachineBasicBlock *RemBB = F->CreateMachineBasicBlock(LLVM_BB);
   F->insert(I, RemBB);
 
   // Update machine-CFG edges by transferring all successors of the current
@@ -1218,53 +1587,39 @@ TNTTargetLowering::EmitShiftInstr(MachineInstr &MI,
                 BB->end());
   RemBB->transferSuccessorsAndUpdatePHIs(BB);
 
-  // Add adges BB => LoopBB => RemBB, BB => RemBB, LoopBB => LoopBB
-  BB->addSuccessor(LoopBB);
-  BB->addSuccessor(RemBB);
-  LoopBB->addSuccessor(RemBB);
-  LoopBB->addSuccessor(LoopBB);
-
-  unsigned ShiftAmtReg = RI.createVirtualRegister(&TNT::GR8RegClass);
-  unsigned ShiftAmtReg2 = RI.createVirtualRegister(&TNT::GR8RegClass);
-  unsigned ShiftReg = RI.createVirtualRegister(RC);
-  unsigned ShiftReg2 = RI.createVirtualRegister(RC);
-  unsigned ShiftAmtSrcReg = MI.getOperand(2).getReg();
-  unsigned SrcReg = MI.getOperand(1).getReg();
-  unsigned DstReg = MI.getOperand(0).getReg();
+  unsigned ShiftReg = SrcReg;
+  MachineBasicBlock *CurBB = BB;
+  unsigned Width = RC == &TNT::GR16RegClass ? 16 : 8;
+  for (unsigned Amount = Width / 2; Amount; Amount /= 2) {
+    MachineBasicBlock *StageBB = F->CreateMachineBasicBlock(LLVM_BB);
+    MachineBasicBlock *NextBB = RemBB;
+    if (Amount != 1) {
+      NextBB = F->CreateMachineBasicBlock(LLVM_BB);
+      F->insert(RemBB->getIterator(), NextBB);
+    }
+    F->insert(NextBB->getIterator(), StageBB);
 
-  // BB:
-  // cmp 0, N
-  // je RemBB
-  BuildMI(BB, dl, TII.get(TNT::CMP8ri))
-    .addReg(ShiftAmtSrcReg).addImm(0);
-  BuildMI(BB, dl, TII.get(TNT::JCC))
-    .addMBB(RemBB)
-    .addImm(TNTCC::COND_E);
-
-  // LoopBB:
-  // ShiftReg = phi [%SrcReg, BB], [%ShiftReg2, LoopBB]
-  // ShiftAmt = phi [%N, BB],      [%ShiftAmt2, LoopBB]
-  // ShiftReg2 = shift ShiftReg
-  // ShiftAmt2 = ShiftAmt - 1;
-  BuildMI(LoopBB, dl, TII.get(TNT::PHI), ShiftReg)
-    .addReg(SrcReg).addMBB(BB)
-    .addReg(ShiftReg2).addMBB(LoopBB);
-  BuildMI(LoopBB, dl, TII.get(TNT::PHI), ShiftAmtReg)
-    .addReg(ShiftAmtSrcReg).addMBB(BB)
-    .addReg(ShiftAmtReg2).addMBB(LoopBB);
-  BuildMI(LoopBB, dl, TII.get(Opc), ShiftReg2)
-    .addReg(ShiftReg);
-  BuildMI(LoopBB, dl, TII.get(TNT::SUB8ri), ShiftAmtReg2)
-    .addReg(ShiftAmtReg).addImm(1);
-  BuildMI(LoopBB, dl, TII.get(TNT::JCC))
-    .addMBB(LoopBB)
-    .addImm(TNTCC::COND_NE);
-
-  // RemBB:
-  // DestReg = phi [%SrcReg, BB], [%ShiftReg, LoopBB]
-  BuildMI(*RemBB, RemBB->begin(), dl, TII.get(TNT::PHI), DstReg)
-    .addReg(SrcReg).addMBB(BB)
-    .addReg(ShiftReg2).addMBB(LoopBB);
+    CurBB->addSuccessor(StageBB);
+    CurBB->addSuccessor(NextBB);
+    StageBB->addSuccessor(NextBB);
+
+    BuildMI(CurBB, dl, TII.get(TNT::BIT8ri))
+      .addReg(ShiftAmtReg).addImm(Amount);
+    BuildMI(CurBB, dl, TII.get(TNT::JCC))
+      .addMBB(NextBB)
+      .addImm(TNTCC::COND_E);
+
+    unsigned ShiftReg2 =
+        emitShiftBy(StageBB, dl, TII, RI, Opc, RC, ShiftReg, Amount);
+
+    unsigned ShiftReg3 = Amount == 1 ? DstReg : RI.createVirtualRegister(RC);
+    BuildMI(*NextBB, NextBB->begin(), dl, TII.get(TNT::PHI), ShiftReg3)
+      .addReg(ShiftReg).addMBB(CurBB)
+      .addReg(ShiftReg2).addMBB(StageBB);
+
+    ShiftReg = ShiftReg3;
+    CurBB = NextBB;
+  }
 
   MI.eraseFromParent(); // The pseudo instruction is gone now.
   return RemBB;
@@ -88,6 +88,205 @@ void TNTInstrInfo::loadRegFromStackSlot(MachineBasicBlock &MBB,
     llvm_unreachable("Cannot store this register to stack slot!");
 }
 
+unsigned TNTInstrInfo::isLoadFromStackSlot(const MachineInstr &MI,
+                                           int &FrameIndex) const {
+  switch (MI.getOpcode()) {
+  default: break;
+  case TNT::MOV8rm:
+  case TNT::MOV16rm:
+    if (MI.getOperand(1).isFI() && MI.getOperand(2).isImm() &&
+        MI.getOperand(2).getImm() == 0) {
+      FrameIndex = MI.getOperand(1).getIndex();
+      return MI.getOperand(0).getReg();
+    }
+    break;
+  }
+  return 0;
+}
+
+unsigned TNTInstrInfo::isStoreToStackSlot(const MachineInstr &MI,
+                                          int &FrameIndex) const {
+  switch (MI.getOpcode()) {
+  default: break;
+  case TNT::MOV8mr:
+  case TNT::MOV16mr:
+    if (MI.getOperand(0).isFI() && MI.getOperand(1).isImm() &&
+        MI.getOperand(1).getImm() == 0) {
+      FrameIndex = MI.getOperand(0).getIndex();
+      return MI.getOperand(2).getReg();
+    }
+    break;
+  }
+  return 0;
+}
+
+unsigned TNTInstrInfo::isLoadFromStackSlotPostFE(const MachineInstr &MI,
+                                                 int &FrameIndex) const {
+  const MachineMemOperand *MMO;
+  if ((MI.getOpcode() == TNT::MOV8rm || MI.getOpcode() == TNT::MOV16rm) &&
+      hasLoadFromStackSlot(MI, MMO, FrameIndex))
+    return MI.getOperand(0).getReg();
+  return 0;
+}
+
+unsigned TNTInstrInfo::isStoreToStackSlotPostFE(const MachineInstr &MI,
+                                                int &FrameIndex) const {
+  const MachineMemOperand *MMO;
+  if ((MI.getOpcode() == TNT::MOV8mr || MI.getOpcode() == TNT::MOV16mr) &&
+      hasStoreToStackSlot(MI, MMO, FrameIndex))
+    return MI.getOperand(2).getReg();
+  return 0;
+}
+
+namespace {
+struct TNTFoldTableEntry {
+  uint16_t RegOp;
+  uint16_t MemOp;
+};
+}
+
+// Register forms whose source operand can be read from memory instead:
+//   OPrr $rd, $src2, $rs -> OPrm $rd, $src2, $mem
+//   CMPrr $rd, $rs       -> CMPrm $rd, $mem
+//   OPmr $dst, $rs       -> OPmm $dst, $mem
+static const TNTFoldTableEntry LoadFoldTable[] = {
+  { TNT::ADD8rr,  TNT::ADD8rm  }, { TNT::ADD16rr, TNT::ADD16rm },
+  { TNT::ADC8rr,  TNT::ADC8rm  }, { TNT::ADC16rr, TNT::ADC16rm },
+  { TNT::SUB8rr,  TNT::SUB8rm  }, { TNT::SUB16rr, TNT::SUB16rm },
+  { TNT::SBC8rr,  TNT::SBC8rm  }, { TNT::SBC16rr, TNT::SBC16rm },
+  { TNT::AND8rr,  TNT::AND8rm  }, { TNT::AND16rr, TNT::AND16rm },
+  { TNT::OR8rr,   TNT::OR8rm   }, { TNT::OR16rr,  TNT::OR16rm  },
+  { TNT::BIC8rr,  TNT::BIC8rm  }, { TNT::BIC16rr, TNT::BIC16rm },
+  { TNT::XOR8rr,  TNT::XOR8rm  }, { TNT::XOR16rr, TNT::XOR16rm },
+  { TNT::CMP8rr,  TNT::CMP8rm  }, { TNT::CMP16rr, TNT::CMP16rm },
+  { TNT::BIT8rr,  TNT::BIT8rm  }, { TNT::BIT16rr, TNT::BIT16rm },
+  { TNT::MOVZX16rr8, TNT::MOVZX16rm8 },
+  { TNT::ADD8mr,  TNT::ADD8mm  }, { TNT::ADD16mr, TNT::ADD16mm },
+  { TNT::ADC8mr,  TNT::ADC8mm  }, { TNT::ADC16mr, TNT::ADC16mm },
+  { TNT::SUB8mr,  TNT::SUB8mm  }, { TNT::SUB16mr, TNT::SUB16mm },
+  { TNT::SBC8mr,  TNT::SBC8mm  }, { TNT::SBC16mr, TNT::SBC16mm },
+  { TNT::AND8mr,  TNT::AND8mm  }, { TNT::AND16mr, TNT::AND16mm },
+  { TNT::OR8mr,   TNT::OR8mm   }, { TNT::OR16mr,  TNT::OR16mm  },
+  { TNT::BIC8mr,  TNT::BIC8mm  }, { TNT::BIC16mr, TNT::BIC16mm },
+  { TNT::XOR8mr,  TNT::XOR8mm  }, { TNT::XOR16mr, TNT::XOR16mm },
+  { TNT::BIT8mr,  TNT::BIT8mm  }, { TNT::BIT16mr, TNT::BIT16mm },
+  { TNT::MOV8mr,  TNT::MOV8mm  }, { TNT::MOV16mr, TNT::MOV16mm },
+};
+
+// Forms whose destination can live in memory, updated in place:
+//   OPrr $rd, $src2, $rs -> OPmr $mem, $rs
+//   OPri $rd, $src2, $imm -> OPmi $mem, $imm
+//   CMPrr $rd, $rs       -> CMPmr $mem, $rs
+//   MOVrm $rd, $src      -> MOVmm $mem, $src
+static const TNTFoldTableEntry StoreFoldTable[] = {
+  { TNT::ADD8rr,  TNT::ADD8mr  }, { TNT::ADD16rr, TNT::ADD16mr },
+  { TNT::ADC8rr,  TNT::ADC8mr  }, { TNT::ADC16rr, TNT::ADC16mr },
+  { TNT::SUB8rr,  TNT::SUB8mr  }, { TNT::SUB16rr, TNT::SUB16mr },
+  { TNT::SBC8rr,  TNT::SBC8mr  }, { TNT::SBC16rr, TNT::SBC16mr },
+  { TNT::AND8rr,  TNT::AND8mr  }, { TNT::AND16rr, TNT::AND16mr },
+  { TNT::OR8rr,   TNT::OR8mr   }, { TNT::OR16rr,  TNT::OR16mr  },
+  { TNT::BIC8rr,  TNT::BIC8mr  }, { TNT::BIC16rr, TNT::BIC16mr },
+  { TNT::XOR8rr,  TNT::XOR8mr  }, { TNT::XOR16rr, TNT::XOR16mr },
+  { TNT::CMP8rr,  TNT::CMP8mr  }, { TNT::CMP16rr, TNT::CMP16mr },
+  { TNT::BIT8rr,  TNT::BIT8mr  }, { TNT::BIT16rr, TNT::BIT16mr },
+  { TNT::ADD8ri,  TNT::ADD8mi  }, { TNT::ADD16ri, TNT::ADD16mi },
+  { TNT::ADC8ri,  TNT::ADC8mi  }, { TNT::ADC16ri, TNT::ADC16mi },
+  { TNT::SUB8ri,  TNT::SUB8mi  }, { TNT::SUB16ri, TNT::SUB16mi },
+  { TNT::SBC8ri,  TNT::SBC8mi  }, { TNT::SBC16ri, TNT::SBC16mi },
+  { TNT::AND8ri,  TNT::AND8mi  }, { TNT::AND16ri, TNT::AND16mi },
+  { TNT::OR8ri,   TNT::OR8mi   }, { TNT::OR16ri,  TNT::OR16mi  },
+  { TNT::XOR8ri,  TNT::XOR8mi  }, { TNT::XOR16ri, TNT::XOR16mi },
+  { TNT::CMP8ri,  TNT::CMP8mi  }, { TNT::CMP16ri, TNT::CMP16mi },
+  { TNT::BIT8ri,  TNT::BIT8mi  }, { TNT::BIT16ri, TNT::BIT16mi },
+  { TNT::MOV8ri,  TNT::MOV8mi  }, { TNT::MOV16ri, TNT::MOV16mi },
+  { TNT::MOV8rm,  TNT::MOV8mm  }, { TNT::MOV16rm, TNT::MOV16mm },
+};
+
+static unsigned lookupFoldTable(ArrayRef<TNTFoldTableEntry> Table,
+                                unsigned Opc) {
+  for (const TNTFoldTableEntry &E : Table)
+    if (E.RegOp == Opc)
+      return E.MemOp;
+  return 0;
+}
+
+/// Rewrite MI to access the memory at {Base, Disp} instead of the register
+/// operands in Ops. Returns null if there is no such form.
+MachineInstr *TNTInstrInfo::foldMemoryOperand(
+    MachineFunction &MF, MachineInstr &MI, ArrayRef<unsigned> Ops,
+    MachineBasicBlock::iterator InsertPt, const MachineOperand &Base,
+    const MachineOperand &Disp, bool CanStore) const {
+  for (unsigned Idx : Ops)
+    if (MI.getOperand(Idx).getSubReg())
+      return nullptr;
+
+  const MCInstrDesc &Desc = MI.getDesc();
+  unsigned NumDefs = Desc.getNumDefs();
+  unsigned MemOpc;
+  // Index of the first explicit operand kept after the memory operand.
+  unsigned KeepFrom;
+
+  if (Ops.size() == 1 && Ops[0] == Desc.getNumOperands() - 1 &&
+      Ops[0] > NumDefs) {
+    // Load fold of the source. Everything before it stays as is.
+    MemOpc = lookupFoldTable(LoadFoldTable, MI.getOpcode());
+    if (!MemOpc)
+      return nullptr;
+
+    MachineInstrBuilder MIB(MF, MF.CreateMachineInstr(get(MemOpc),
+                                                      MI.getDebugLoc(), true));
+    for (unsigned i = 0; i != Ops[0]; ++i)
+      MIB.addOperand(MI.getOperand(i));
+    MIB.addOperand(Base).addOperand(Disp);
+    KeepFrom = Ops[0] + 1;
+    for (unsigned i = KeepFrom, e = MI.getNumOperands(); i != e; ++i)
+      MIB.addOperand(MI.getOperand(i));
+    return &*MI.getParent()->insert(InsertPt, MIB);
+  }
+
+  // Fold of the destination: the def together with its tied use, or the
+  // first operand of a compare, which is only read.
+  bool Tied = NumDefs == 1 && Desc.getOperandConstraint(1, MCOI::TIED_TO) == 0;
+  if (NumDefs == 1 && !CanStore)
+    return nullptr;
+  if (Tied ? (Ops.size() != 2 || Ops[0] != 0 || Ops[1] != 1)
+           : (Ops.size() != 1 || Ops[0] != 0))
+    return nullptr;
+  KeepFrom = Tied ? 2 : 1;
+
+  MemOpc = lookupFoldTable(StoreFoldTable, MI.getOpcode());
+  if (!MemOpc)
+    return nullptr;
+
+  MachineInstrBuilder MIB(MF, MF.CreateMachineInstr(get(MemOpc),
+                                                    MI.getDebugLoc(), true));
+  MIB.addOperand(Base).addOperand(Disp);
+  for (unsigned i = KeepFrom, e = MI.getNumOperands(); i != e; ++i)
+    MIB.addOperand(MI.getOperand(i));
+  return &*MI.getParent()->insert(InsertPt, MIB);
+}
+
+MachineInstr *TNTInstrInfo::foldMemoryOperandImpl(
+    MachineFunction &MF, MachineInstr &MI, ArrayRef<unsigned> Ops,
+    MachineBasicBlock::iterator InsertPt, int FrameIndex,
+    LiveIntervals *LIS) const {
+  return foldMemoryOperand(MF, MI, Ops, InsertPt,
+                           MachineOperand::CreateFI(FrameIndex),
+                           MachineOperand::CreateImm(0), /*CanStore=*/true);
+}
+
+MachineInstr *TNTInstrInfo::foldMemoryOperandImpl(
+    MachineFunction &MF, MachineInstr &MI, ArrayRef<unsigned> Ops,
+    MachineBasicBlock::iterator InsertPt, MachineInstr &LoadMI,
+    LiveIntervals *LIS) const {
+  if (LoadMI.getOpcode() != TNT::MOV8rm && LoadMI.getOpcode() != TNT::MOV16rm)
+    return nullptr;
+
+  // The loaded value is only known to be dead after MI when it is a use.
+  return foldMemoryOperand(MF, MI, Ops, InsertPt, LoadMI.getOperand(1),
+                           LoadMI.getOperand(2), /*CanStore=*/false);
+}
+
 void TNTInstrInfo::copyPhysReg(MachineBasicBlock &MBB,
                                   MachineBasicBlock::iterator I,
                                   const DebugLoc &DL, unsigned DestReg,
@@ -152,6 +351,9 @@ ReverseBranchCondition(SmallVectorImpl<MachineOperand> &Cond) const {
   case TNTCC::COND_LO:
     CC = TNTCC::COND_HS;
     break;
+  case TNTCC::COND_N:
+    // jn has no inverse.
+    return true;
   }
 
   Cond[0].setImm(CC);
@@ -193,8 +395,13 @@ bool TNTInstrInfo::analyzeBranch(MachineBasicBlock &MBB,
     if (!I->isBranch())
       return true;
 
+    // Generic branches are only understood once they have been selected.
+    if (isPreISelGenericOpcode(I->getOpcode()))
+      return true;
+
     // Cannot handle indirect branches.
     if (I->getOpcode() == TNT::Br ||
+        I->getOpcode() == TNT::Bi ||
         I->getOpcode() == TNT::Bm)
       return true;
 
@@ -290,6 +497,249 @@ unsigned TNTInstrInfo::InsertBranch(MachineBasicBlock &MBB,
   return Count;
 }
 
+bool TNTInstrInfo::analyzeCompare(const MachineInstr &MI, unsigned &SrcReg,
+                                  unsigned &SrcReg2, int &CmpMask,
+                                  int &CmpValue) const {
+  switch (MI.getOpcode()) {
+  default: break;
+  case TNT::CMP8ri:
+  case TNT::CMP16ri:
+    if (!MI.getOperand(1).isImm())
+      return false;
+    SrcReg = MI.getOperand(0).getReg();
+    SrcReg2 = 0;
+    CmpMask = ~0;
+    CmpValue = MI.getOperand(1).getImm();
+    return true;
+  case TNT::CMP8rr:
+  case TNT::CMP16rr:
+    SrcReg = MI.getOperand(0).getReg();
+    SrcReg2 = MI.getOperand(1).getReg();
+    CmpMask = ~0;
+    CmpValue = 0;
+    return true;
+  }
+
+  return false;
+}
+
+/// How the flags set by an instruction relate to those of comparing its
+/// result with zero.
+enum FlagsKind {
+  FlagsNone,    // Not usable in place of the comparison.
+  FlagsZN,      // Z and N are set from the result.
+  FlagsZNV      // As above, and V is cleared.
+};
+
+static FlagsKind getResultFlagsKind(unsigned Opcode) {
+  switch (Opcode) {
+  default:
+    return FlagsNone;
+  case TNT::ADD8rr:  case TNT::ADD16rr:  case TNT::ADD8ri:  case TNT::ADD16ri:
+  case TNT::ADD8rm:  case TNT::ADD16rm:
+  case TNT::ADD8rm_POST:  case TNT::ADD16rm_POST:
+  case TNT::ADC8rr:  case TNT::ADC16rr:  case TNT::ADC8ri:  case TNT::ADC16ri:
+  case TNT::ADC8rm:  case TNT::ADC16rm:
+  case TNT::SUB8rr:  case TNT::SUB16rr:  case TNT::SUB8ri:  case TNT::SUB16ri:
+  case TNT::SUB8rm:  case TNT::SUB16rm:
+  case TNT::SUB8rm_POST:  case TNT::SUB16rm_POST:
+  case TNT::SBC8rr:  case TNT::SBC16rr:  case TNT::SBC8ri:  case TNT::SBC16ri:
+  case TNT::SBC8rm:  case TNT::SBC16rm:
+  case TNT::XOR8rr:  case TNT::XOR16rr:  case TNT::XOR8ri:  case TNT::XOR16ri:
+  case TNT::XOR8rm:  case TNT::XOR16rm:
+  case TNT::XOR8rm_POST:  case TNT::XOR16rm_POST:
+  case TNT::SHL8r1:  case TNT::SHL16r1:
+    return FlagsZN;
+  case TNT::AND8rr:  case TNT::AND16rr:  case TNT::AND8ri:  case TNT::AND16ri:
+  case TNT::AND8rm:  case TNT::AND16rm:
+  case TNT::AND8rm_POST:  case TNT::AND16rm_POST:
+  case TNT::SAR8r1:  case TNT::SAR16r1:  case TNT::SAR8r1c: case TNT::SAR16r1c:
+  case TNT::SEXT16r:
+    return FlagsZNV;
+  }
+}
+
+/// isRedundantSub - Return true if MI is a subtraction setting the same
+/// flags as comparing SrcReg with SrcReg2, or with the immediate ImmValue if
+/// SrcReg2 is 0.
+static bool isRedundantSub(const MachineInstr &MI, unsigned SrcReg,
+                           unsigned SrcReg2, int ImmValue) {
+  switch (MI.getOpcode()) {
+  default:
+    return false;
+  case TNT::SUB8rr:
+  case TNT::SUB16rr:
+    return SrcReg2 && MI.getOperand(1).getReg() == SrcReg &&
+           MI.getOperand(2).getReg() == SrcReg2;
+  case TNT::SUB8ri:
+  case TNT::SUB16ri:
+    return !SrcReg2 && MI.getOperand(1).getReg() == SrcReg &&
+           MI.getOperand(2).isImm() && MI.getOperand(2).getImm() == ImmValue;
+  }
+}
+
+/// isSafeCondition - Return true if a branch on CC gives the same result
+/// with flags of the given kind as after the comparison with zero.
+static bool isSafeCondition(TNTCC::CondCodes CC, FlagsKind Kind) {
+  switch (CC) {
+  case TNTCC::COND_E:
+  case TNTCC::COND_NE:
+  case TNTCC::COND_N:
+    return Kind != FlagsNone;
+  case TNTCC::COND_GE:
+  case TNTCC::COND_L:
+    // The comparison clears V, so these only look at N.
+    return Kind == FlagsZNV;
+  default:
+    // The comparison always sets C.
+    return false;
+  }
+}
+
+/// optimizeCompareInstr - Almost every arithmetic instruction sets the flags.
+/// Remove a comparison whose flags are already known: either the value is
+/// compared with zero right after being computed, or the same subtraction
+/// has been done before.
+bool TNTInstrInfo::optimizeCompareInstr(MachineInstr &CmpInstr,
+                                        unsigned SrcReg, unsigned SrcReg2,
+                                        int CmpMask, int CmpValue,
+                                        const MachineRegisterInfo *MRI) const {
+  bool IsZeroCmp = !SrcReg2 && CmpValue == 0;
+  MachineInstr *SrcDef = MRI->getUniqueVRegDef(SrcReg);
+  MachineBasicBlock *MBB = CmpInstr.getParent();
+  const TargetRegisterInfo *TRI = &getRegisterInfo();
+
+  // Look backwards for the instruction whose flags to reuse. Nothing in
+  // between may read the flags; if something clobbers them, FlagDef has to
+  // be moved down to the comparison.
+  MachineInstr *FlagDef = nullptr;
+  FlagsKind Kind = FlagsNone;
+  bool Clobbered = false;
+  for (MachineBasicBlock::iterator I = CmpInstr, E = MBB->begin(); I != E;) {
+    MachineInstr &Inst = *--I;
+
+    if (IsZeroCmp && &Inst == SrcDef &&
+        getResultFlagsKind(Inst.getOpcode()) != FlagsNone) {
+      FlagDef = &Inst;
+      Kind = getResultFlagsKind(Inst.getOpcode());
+      break;
+    }
+    if (isRedundantSub(Inst, SrcReg, SrcReg2, CmpValue)) {
+      FlagDef = &Inst;
+      break;
+    }
+
+    if (Inst.readsRegister(TNT::SR, TRI) || Inst.isCall() ||
+        Inst.hasUnmodeledSideEffects())
+      return false;
+    if (Inst.modifiesRegister(TNT::SR, TRI))
+      Clobbered = true;
+  }
+  if (!FlagDef)
+    return false;
+
+  // Scheduling often puts an unrelated update, say of a loop pointer,
+  // between the instruction and the comparison. Sink the instruction past
+  // it when that can't change what it computes.
+  if (Clobbered) {
+    if (FlagDef->mayLoadOrStore() || FlagDef->readsRegister(TNT::SR, TRI) ||
+        FlagDef->hasUnmodeledSideEffects())
+      return false;
+    for (const MachineOperand &MO : FlagDef->operands())
+      if (MO.isReg() && MO.getReg() != TNT::SR &&
+          !TargetRegisterInfo::isVirtualRegister(MO.getReg()))
+        return false;
+    for (MachineBasicBlock::iterator I = std::next(FlagDef->getIterator()),
+                                     E = CmpInstr.getIterator();
+         I != E; ++I)
+      for (const MachineOperand &MO : FlagDef->defs())
+        if (MO.isReg() && MO.getReg() != TNT::SR &&
+            I->readsRegister(MO.getReg()))
+          return false;
+  }
+
+  // A redundant subtraction sets exactly the same flags; otherwise check
+  // that every reader of the flags only looks at ones that agree.
+  if (Kind != FlagsNone) {
+    for (MachineBasicBlock::iterator I = std::next(CmpInstr.getIterator()),
+                                     E = MBB->end();
+         I != E; ++I) {
+      bool Reads = I->readsRegister(TNT::SR, TRI);
+      if (Reads) {
+        if (I->getOpcode() != TNT::JCC ||
+            !isSafeCondition(TNTCC::CondCodes(I->getOperand(1).getImm()),
+                             Kind))
+          return false;
+      }
+      if (!Reads && I->modifiesRegister(TNT::SR, TRI))
+        break;
+      if (std::next(I) == E)
+        for (const MachineBasicBlock *Succ : MBB->successors())
+          if (Succ->isLiveIn(TNT::SR))
+            return false;
+    }
+  }
+
+  if (Clobbered)
+    MBB->splice(CmpInstr.getIterator(), MBB, FlagDef->getIterator());
+
+  // The flags of FlagDef are live now.
+  if (MachineOperand *MO = FlagDef->findRegisterDefOperand(TNT::SR))
+    MO->setIsDead(false);
+  CmpInstr.eraseFromParent();
+  return true;
+}
+
+// Registers of the memory-mapped hardware multiplier. Writing the second
+// operand starts the multiplication, whose result is available to the next
+// instruction.
+enum {
+  HWMultMPY   = 0x0130, // First operand, unsigned multiply
+  HWMultMPYS  = 0x0132, // First operand, signed multiply
+  HWMultOP2   = 0x0138, // Second operand
+  HWMultRESLO = 0x013A, // Low half of the result
+  HWMultRESHI = 0x013C  // High half of the result
+};
+
+bool TNTInstrInfo::expandPostRAPseudo(MachineInstr &MI) const {
+  unsigned OpAddr, ResAddr;
+  switch (MI.getOpcode()) {
+  default:
+    return false;
+  case TNT::HWMul16:
+    OpAddr = HWMultMPY;
+    ResAddr = HWMultRESLO;
+    break;
+  case TNT::HWMulHU16:
+    OpAddr = HWMultMPY;
+    ResAddr = HWMultRESHI;
+    break;
+  case TNT::HWMulHS16:
+    OpAddr = HWMultMPYS;
+    ResAddr = HWMultRESHI;
+    break;
+  }
+
+  MachineBasicBlock &MBB = *MI.getParent();
+  DebugLoc DL = MI.getDebugLoc();
+  const MachineOperand &Dst = MI.getOperand(0);
+  const MachineOperand &Src = MI.getOperand(1);
+  const MachineOperand &Src2 = MI.getOperand(2);
+
+  // Absolute addresses use a null base register.
+  BuildMI(MBB, MI, DL, get(TNT::MOV16mr))
+    .addReg(0).addImm(OpAddr)
+    .addReg(Src.getReg(), getKillRegState(Src.isKill()));
+  BuildMI(MBB, MI, DL, get(TNT::MOV16mr))
+    .addReg(0).addImm(HWMultOP2)
+    .addReg(Src2.getReg(), getKillRegState(Src2.isKill()));
+  BuildMI(MBB, MI, DL, get(TNT::MOV16rm), Dst.getReg())
+    .addReg(0).addImm(ResAddr);
+
+  MBB.erase(MI);
+  return true;
+}
+
 /// GetInstSize - Return the number of bytes of code the specified
 /// instruction may be.  This returns the maximum number of bytes.
 ///
@@ -328,3 +778,81 @@ unsigned TNTInstrInfo::GetInstSizeInBytes(const MachineInstr &MI) const {
     return 6;
   }
 }
+
+bool TNTInstrInfo::isFunctionSafeToOutlineFrom(MachineFunction &MF) const {
+  return true;
+}
+
+TNTInstrInfo::MachineOutlinerInstrType
+TNTInstrInfo::getOutliningType(MachineInstr &MI) const {
+  switch (MI.getOpcode()) {
+  case TargetOpcode::DBG_VALUE:
+  case TargetOpcode::KILL:
+  case TargetOpcode::IMPLICIT_DEF:
+    return Invisible;
+  case TNT::RETI:
+    return Illegal;
+  }
+
+  // Labels, inline asm and anything else without a known encoding stay put.
+  if ((MI.getDesc().TSFlags & TNTII::SizeMask) == TNTII::SizeUnknown)
+    return Illegal;
+
+  // Branches would need their targets rewritten.
+  if (MI.isReturn())
+    return LegalInTailCall;
+  if (MI.isTerminator() || MI.isBranch())
+    return Illegal;
+
+  // Constant pools and jump tables belong to the function that uses them.
+  for (const MachineOperand &MO : MI.operands())
+    if (MO.isMBB() || MO.isCPI() || MO.isJTI() || MO.isCFIIndex() ||
+        MO.isMCSymbol())
+      return Illegal;
+
+  // Calling the outlined function pushes a return address, which would move
+  // anything addressed relative to SP and anything a call pushes or pops.
+  if (MI.isCall() || MI.readsRegister(TNT::SP) ||
+      MI.modifiesRegister(TNT::SP, &RI))
+    return LegalInTailCall;
+
+  return Legal;
+}
+
+unsigned
+TNTInstrInfo::getOutliningBenefit(ArrayRef<const MachineInstr *> Sequence,
+                                  unsigned Occurrences,
+                                  bool IsTailCall) const {
+  unsigned SequenceSize = 0;
+  for (const MachineInstr *MI : Sequence)
+    SequenceSize += GetInstSizeInBytes(*MI);
+
+  // Each occurrence becomes a 4-byte "call #f" or "br #f", and a called
+  // function needs a "ret" of its own.
+  unsigned CallSize = 4;
+  unsigned NotOutlined = SequenceSize * Occurrences;
+  unsigned Outlined = CallSize * Occurrences + SequenceSize;
+  if (!IsTailCall)
+    Outlined += 2;
+  return NotOutlined > Outlined ? NotOutlined - Outlined : 0;
+}
+
+void TNTInstrInfo::insertOutlinerEpilogue(MachineBasicBlock &MBB,
+                                          MachineFunction &MF,
+                                          bool IsTailCall) const {
+  // A tail-called sequence ends in the caller's own return.
+  if (!IsTailCall)
+    BuildMI(MBB, MBB.end(), DebugLoc(), get(TNT::RET));
+}
+
+MachineBasicBlock::iterator
+TNTInstrInfo::insertOutlinedCall(MachineBasicBlock &MBB,
+                                 MachineBasicBlock::iterator It,
+                                 MachineFunction &MF, bool IsTailCall) const {
+  const GlobalValue *Callee = MF.getFunction();
+  if (IsTailCall)
+    return BuildMI(MBB, It, DebugLoc(), get(TNT::Bi))
+        .addGlobalAddress(Callee);
+  return BuildMI(MBB, It, DebugLoc(), get(TNT::CALLi))
+      .addGlobalAddress(Callee);
+}
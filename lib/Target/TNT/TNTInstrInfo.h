@@ -68,8 +68,39 @@ public:
                             const TargetRegisterClass *RC,
                             const TargetRegisterInfo *TRI) const override;
 
+  unsigned isLoadFromStackSlot(const MachineInstr &MI,
+                               int &FrameIndex) const override;
+  unsigned isStoreToStackSlot(const MachineInstr &MI,
+                              int &FrameIndex) const override;
+  unsigned isLoadFromStackSlotPostFE(const MachineInstr &MI,
+                                     int &FrameIndex) const override;
+  unsigned isStoreToStackSlotPostFE(const MachineInstr &MI,
+                                    int &FrameIndex) const override;
+
+  using TargetInstrInfo::foldMemoryOperandImpl;
+  MachineInstr *
+  foldMemoryOperandImpl(MachineFunction &MF, MachineInstr &MI,
+                        ArrayRef<unsigned> Ops,
+                        MachineBasicBlock::iterator InsertPt, int FrameIndex,
+                        LiveIntervals *LIS = nullptr) const override;
+  MachineInstr *
+  foldMemoryOperandImpl(MachineFunction &MF, MachineInstr &MI,
+                        ArrayRef<unsigned> Ops,
+                        MachineBasicBlock::iterator InsertPt,
+                        MachineInstr &LoadMI,
+                        LiveIntervals *LIS = nullptr) const override;
+
   unsigned GetInstSizeInBytes(const MachineInstr &MI) const;
 
+  bool expandPostRAPseudo(MachineInstr &MI) const override;
+
+  bool analyzeCompare(const MachineInstr &MI, unsigned &SrcReg,
+                      unsigned &SrcReg2, int &CmpMask,
+                      int &CmpValue) const override;
+  bool optimizeCompareInstr(MachineInstr &CmpInstr, unsigned SrcReg,
+                            unsigned SrcReg2, int CmpMask, int CmpValue,
+                            const MachineRegisterInfo *MRI) const override;
+
   // Branch folding goodness
   bool
   ReverseBranchCondition(SmallVectorImpl<MachineOperand> &Cond) const override;
@@ -83,6 +114,26 @@ public:
   unsigned InsertBranch(MachineBasicBlock &MBB, MachineBasicBlock *TBB,
                         MachineBasicBlock *FBB, ArrayRef<MachineOperand> Cond,
                         const DebugLoc &DL) const override;
+
+  // Machine outliner hooks. Outlining is measured in bytes of code.
+  bool isFunctionSafeToOutlineFrom(MachineFunction &MF) const override;
+  MachineOutlinerInstrType getOutliningType(MachineInstr &MI) const override;
+  unsigned getOutliningBenefit(ArrayRef<const MachineInstr *> Sequence,
+                               unsigned Occurrences,
+                               bool IsTailCall) const override;
+  void insertOutlinerEpilogue(MachineBasicBlock &MBB, MachineFunction &MF,
+                              bool IsTailCall) const override;
+  MachineBasicBlock::iterator
+  insertOutlinedCall(MachineBasicBlock &MBB, MachineBasicBlock::iterator It,
+                     MachineFunction &MF, bool IsTailCall) const override;
+
+private:
+  MachineInstr *foldMemoryOperand(MachineFunction &MF, MachineInstr &MI,
+                                  ArrayRef<unsigned> Ops,
+                                  MachineBasicBlock::iterator InsertPt,
+                                  const MachineOperand &Base,
+                                  const MachineOperand &Disp,
+                                  bool CanStore) const;
 };
 
 }
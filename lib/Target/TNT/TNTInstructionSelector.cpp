@@ -0,0 +1,197 @@
+//===-- TNTInstructionSelector.cpp - TNT Instruction Selector -------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the targeting of the InstructionSelector class for
+/// TNT.
+//===----------------------------------------------------------------------===//
+
+#include "TNTInstructionSelector.h"
+#include "TNTInstrInfo.h"
+#include "TNTRegisterBankInfo.h"
+#include "TNTSubtarget.h"
+#include "llvm/CodeGen/MachineBasicBlock.h"
+#include "llvm/CodeGen/MachineFunction.h"
+#include "llvm/CodeGen/MachineInstr.h"
+#include "llvm/CodeGen/MachineInstrBuilder.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/IR/Type.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "tnt-isel"
+
+using namespace llvm;
+
+#ifndef LLVM_BUILD_GLOBAL_ISEL
+#error "You shouldn't build this"
+#endif
+
+TNTInstructionSelector::TNTInstructionSelector(
+    const TNTSubtarget &STI, const TNTRegisterBankInfo &RBI)
+    : InstructionSelector(), TII(*STI.getInstrInfo()),
+      TRI(*STI.getRegisterInfo()), RBI(RBI) {}
+
+/// Return the register class holding \p Size-bit values.
+static const TargetRegisterClass *getRegClassForSize(unsigned Size) {
+  if (Size <= 8)
+    return &TNT::GR8RegClass;
+  if (Size <= 16)
+    return &TNT::GR16RegClass;
+  return nullptr;
+}
+
+/// If \p Reg is defined by a G_CONSTANT, return true and set \p Imm to its
+/// value.
+static bool getConstantVRegVal(unsigned Reg, const MachineRegisterInfo &MRI,
+                               int64_t &Imm) {
+  MachineInstr *Def = MRI.getVRegDef(Reg);
+  if (!Def || Def->getOpcode() != TargetOpcode::G_CONSTANT)
+    return false;
+  Imm = Def->getOperand(1).getImm();
+  return true;
+}
+
+/// Select the opcode for the generic binary operation \p GenericOpc on
+/// \p Size-bit values, with an immediate second operand if \p IsImm.
+static unsigned selectBinaryOpcode(unsigned GenericOpc, unsigned Size,
+                                   bool IsImm) {
+  static const unsigned Opcodes[][4] = {
+    // 8rr          16rr          8ri           16ri
+    { TNT::ADD8rr, TNT::ADD16rr, TNT::ADD8ri, TNT::ADD16ri },
+    { TNT::SUB8rr, TNT::SUB16rr, TNT::SUB8ri, TNT::SUB16ri },
+    { TNT::AND8rr, TNT::AND16rr, TNT::AND8ri, TNT::AND16ri },
+    { TNT::OR8rr,  TNT::OR16rr,  TNT::OR8ri,  TNT::OR16ri  },
+    { TNT::XOR8rr, TNT::XOR16rr, TNT::XOR8ri, TNT::XOR16ri },
+  };
+
+  unsigned Row;
+  switch (GenericOpc) {
+  default: return GenericOpc;
+  case TargetOpcode::G_ADD: Row = 0; break;
+  case TargetOpcode::G_SUB: Row = 1; break;
+  case TargetOpcode::G_AND: Row = 2; break;
+  case TargetOpcode::G_OR:  Row = 3; break;
+  case TargetOpcode::G_XOR: Row = 4; break;
+  }
+
+  if (Size != 8 && Size != 16)
+    return GenericOpc;
+  return Opcodes[Row][(IsImm ? 2 : 0) + (Size == 16 ? 1 : 0)];
+}
+
+bool TNTInstructionSelector::selectCopy(MachineInstr &I,
+                                        MachineRegisterInfo &MRI) const {
+  // Generic virtual registers read or written by a copy only have a size:
+  // give them the class of the registers that hold values of that size.
+  for (const MachineOperand &MO : I.operands()) {
+    if (!MO.isReg() || !TargetRegisterInfo::isVirtualRegister(MO.getReg()) ||
+        MRI.getRegClassOrNull(MO.getReg()))
+      continue;
+    const TargetRegisterClass *RC =
+        getRegClassForSize(MRI.getSize(MO.getReg()));
+    if (!RC) {
+      DEBUG(dbgs() << "Unsupported copy size: " << I);
+      return false;
+    }
+    MRI.setRegClass(MO.getReg(), RC);
+  }
+  return true;
+}
+
+bool TNTInstructionSelector::selectBinaryOp(MachineInstr &I,
+                                            MachineRegisterInfo &MRI) const {
+  unsigned Size = I.getType()->getIntegerBitWidth();
+  unsigned DstReg = I.getOperand(0).getReg();
+  unsigned Src1Reg = I.getOperand(1).getReg();
+  unsigned Src2Reg = I.getOperand(2).getReg();
+
+  // Fold a constant operand into the immediate form. Only the source
+  // operand of the two-address instructions can be an immediate.
+  int64_t Imm;
+  bool IsImm = getConstantVRegVal(Src2Reg, MRI, Imm);
+  if (!IsImm && I.getOpcode() != TargetOpcode::G_SUB &&
+      getConstantVRegVal(Src1Reg, MRI, Imm)) {
+    std::swap(Src1Reg, Src2Reg);
+    IsImm = true;
+  }
+
+  unsigned NewOpc = selectBinaryOpcode(I.getOpcode(), Size, IsImm);
+  if (NewOpc == I.getOpcode())
+    return false;
+
+  MachineInstrBuilder MIB =
+      BuildMI(*I.getParent(), I, I.getDebugLoc(), TII.get(NewOpc), DstReg)
+          .addReg(Src1Reg);
+  if (IsImm)
+    MIB.addImm(Imm);
+  else
+    MIB.addReg(Src2Reg);
+  I.eraseFromParent();
+  return constrainSelectedInstRegOperands(*MIB, TII, TRI, RBI);
+}
+
+bool TNTInstructionSelector::selectConstant(MachineInstr &I,
+                                            MachineRegisterInfo &MRI) const {
+  unsigned DstReg = I.getOperand(0).getReg();
+  // All the users have been selected already. If they all folded the value,
+  // there is nothing left to materialize.
+  if (MRI.use_empty(DstReg)) {
+    I.eraseFromParent();
+    return true;
+  }
+
+  unsigned Size = I.getType()->getIntegerBitWidth();
+  if (Size != 8 && Size != 16)
+    return false;
+  MachineInstr *MI =
+      BuildMI(*I.getParent(), I, I.getDebugLoc(),
+              TII.get(Size == 8 ? TNT::MOV8ri : TNT::MOV16ri), DstReg)
+          .addImm(I.getOperand(1).getImm());
+  I.eraseFromParent();
+  return constrainSelectedInstRegOperands(*MI, TII, TRI, RBI);
+}
+
+bool TNTInstructionSelector::select(MachineInstr &I) const {
+  assert(I.getParent() && "Instruction should be in a basic block!");
+  assert(I.getParent()->getParent() && "Instruction should be in a function!");
+
+  MachineBasicBlock &MBB = *I.getParent();
+  MachineFunction &MF = *MBB.getParent();
+  MachineRegisterInfo &MRI = MF.getRegInfo();
+
+  if (!isPreISelGenericOpcode(I.getOpcode())) {
+    // Target instructions built during the translation, such as the
+    // argument and return value copies, only need their generic virtual
+    // registers constrained.
+    if (I.isCopy())
+      return selectCopy(I, MRI);
+    return true;
+  }
+
+  switch (I.getOpcode()) {
+  case TargetOpcode::G_ADD:
+  case TargetOpcode::G_SUB:
+  case TargetOpcode::G_AND:
+  case TargetOpcode::G_OR:
+  case TargetOpcode::G_XOR:
+    return selectBinaryOp(I, MRI);
+
+  case TargetOpcode::G_CONSTANT:
+    return selectConstant(I, MRI);
+
+  case TargetOpcode::G_BR:
+    BuildMI(MBB, I, I.getDebugLoc(), TII.get(TNT::JMP))
+        .addMBB(I.getOperand(0).getMBB());
+    I.eraseFromParent();
+    return true;
+
+  default:
+    return false;
+  }
+}
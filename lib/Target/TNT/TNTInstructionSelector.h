@@ -0,0 +1,43 @@
+//===-- TNTInstructionSelector.h - TNT Instruction Selector -----*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file declares the targeting of the InstructionSelector class for TNT.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_TARGET_TNT_TNTINSTRUCTIONSELECTOR_H
+#define LLVM_LIB_TARGET_TNT_TNTINSTRUCTIONSELECTOR_H
+
+#include "llvm/CodeGen/GlobalISel/InstructionSelector.h"
+
+namespace llvm {
+class MachineRegisterInfo;
+class TargetRegisterInfo;
+class TNTInstrInfo;
+class TNTRegisterBankInfo;
+class TNTSubtarget;
+
+class TNTInstructionSelector : public InstructionSelector {
+public:
+  TNTInstructionSelector(const TNTSubtarget &STI,
+                         const TNTRegisterBankInfo &RBI);
+
+  bool select(MachineInstr &I) const override;
+
+private:
+  bool selectCopy(MachineInstr &I, MachineRegisterInfo &MRI) const;
+  bool selectBinaryOp(MachineInstr &I, MachineRegisterInfo &MRI) const;
+  bool selectConstant(MachineInstr &I, MachineRegisterInfo &MRI) const;
+
+  const TNTInstrInfo &TII;
+  const TargetRegisterInfo &TRI;
+  const TNTRegisterBankInfo &RBI;
+};
+
+} // End llvm namespace.
+#endif
@@ -0,0 +1,33 @@
+//===-- TNTLegalizerInfo.cpp - TNT Legalizer ------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the targeting of the LegalizerInfo class for TNT.
+//===----------------------------------------------------------------------===//
+
+#include "TNTLegalizerInfo.h"
+#include "llvm/Target/TargetOpcodes.h"
+
+using namespace llvm;
+
+#ifndef LLVM_BUILD_GLOBAL_ISEL
+#error "You shouldn't build this"
+#endif
+
+TNTLegalizerInfo::TNTLegalizerInfo() {
+  // Every ALU instruction has a byte and a word form. Narrower values are
+  // widened to bytes by the default rule; wider ones are not supported yet.
+  for (unsigned Op : {TargetOpcode::G_ADD, TargetOpcode::G_SUB,
+                      TargetOpcode::G_AND, TargetOpcode::G_OR,
+                      TargetOpcode::G_XOR, TargetOpcode::G_CONSTANT}) {
+    setAction(Op, 8, Legal);
+    setAction(Op, 16, Legal);
+  }
+
+  setAction(TargetOpcode::G_BR, 0, Legal);
+}
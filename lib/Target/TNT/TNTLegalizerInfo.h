@@ -0,0 +1,26 @@
+//===-- TNTLegalizerInfo.h - TNT Legalizer ----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file declares the targeting of the LegalizerInfo class for TNT.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_TARGET_TNT_TNTLEGALIZERINFO_H
+#define LLVM_LIB_TARGET_TNT_TNTLEGALIZERINFO_H
+
+#include "llvm/CodeGen/GlobalISel/LegalizerInfo.h"
+
+namespace llvm {
+
+/// This class provides the information for the target's legalization rules.
+class TNTLegalizerInfo : public LegalizerInfo {
+public:
+  TNTLegalizerInfo();
+};
+} // End llvm namespace.
+#endif
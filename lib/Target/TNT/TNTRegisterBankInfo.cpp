@@ -0,0 +1,49 @@
+//===-- TNTRegisterBankInfo.cpp - TNT Register Bank Info ------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file implements the targeting of the RegisterBankInfo class for TNT.
+//===----------------------------------------------------------------------===//
+
+#include "TNTRegisterBankInfo.h"
+#include "MCTargetDesc/TNTMCTargetDesc.h" // For XXXRegClassID.
+#include "llvm/CodeGen/GlobalISel/RegisterBank.h"
+#include "llvm/Target/TargetRegisterInfo.h"
+
+using namespace llvm;
+
+#ifndef LLVM_BUILD_GLOBAL_ISEL
+#error "You shouldn't build this"
+#endif
+
+TNTRegisterBankInfo::TNTRegisterBankInfo(const TargetRegisterInfo &TRI)
+    : RegisterBankInfo(TNT::NumRegisterBanks) {
+  // Initialize the GPR bank.
+  createRegisterBank(TNT::GPRRegBankID, "GPR");
+  // The GPR register bank is fully defined by all the registers in
+  // GR16 + its subclasses.
+  addRegBankCoverage(TNT::GPRRegBankID, TNT::GR16RegClassID, TRI);
+  const RegisterBank &RBGPR = getRegBank(TNT::GPRRegBankID);
+  (void)RBGPR;
+  assert(RBGPR.covers(*TRI.getRegClass(TNT::GR8RegClassID)) &&
+         "Subclass not added?");
+  assert(RBGPR.getSize() == 16 && "GPRs should hold up to 16-bit");
+
+  assert(verify(TRI) && "Invalid register bank information");
+}
+
+const RegisterBank &TNTRegisterBankInfo::getRegBankFromRegClass(
+    const TargetRegisterClass &RC) const {
+  switch (RC.getID()) {
+  case TNT::GR8RegClassID:
+  case TNT::GR16RegClassID:
+    return getRegBank(TNT::GPRRegBankID);
+  default:
+    llvm_unreachable("Register class not supported");
+  }
+}
@@ -0,0 +1,41 @@
+//===-- TNTRegisterBankInfo.h - TNT Register Bank Info ----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+/// \file
+/// This file declares the targeting of the RegisterBankInfo class for TNT.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_TARGET_TNT_TNTREGISTERBANKINFO_H
+#define LLVM_LIB_TARGET_TNT_TNTREGISTERBANKINFO_H
+
+#include "llvm/CodeGen/GlobalISel/RegisterBankInfo.h"
+
+namespace llvm {
+
+class TargetRegisterInfo;
+
+namespace TNT {
+enum {
+  GPRRegBankID = 0, /// General Purpose Registers: rN and rNB.
+  NumRegisterBanks
+};
+} // End TNT namespace.
+
+/// This class provides the information for the target register banks.
+/// All the values live in the general purpose registers, so there is a
+/// single bank and there is never anything to repair.
+class TNTRegisterBankInfo : public RegisterBankInfo {
+public:
+  TNTRegisterBankInfo(const TargetRegisterInfo &TRI);
+
+  /// Get a register bank that covers \p RC.
+  const RegisterBank &
+  getRegBankFromRegClass(const TargetRegisterClass &RC) const override;
+};
+} // End llvm namespace.
+#endif
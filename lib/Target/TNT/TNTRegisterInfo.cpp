@@ -38,40 +38,24 @@ TNTRegisterInfo::TNTRegisterInfo()
 const MCPhysReg*
 TNTRegisterInfo::getCalleeSavedRegs(const MachineFunction *MF) const {
   const TNTFrameLowering *TFI = getFrameLowering(*MF);
-  const Function* F = MF->getFunction();
-  static const MCPhysReg CalleeSavedRegs[] = {
-    TNT::FP, TNT::R5, TNT::R6, TNT::R7,
-    TNT::R8, TNT::R9, TNT::R10, TNT::R11,
-    0
-  };
-  static const MCPhysReg CalleeSavedRegsFP[] = {
-    TNT::R5, TNT::R6, TNT::R7,
-    TNT::R8, TNT::R9, TNT::R10, TNT::R11,
-    0
-  };
-  static const MCPhysReg CalleeSavedRegsIntr[] = {
-    TNT::FP,  TNT::R5,  TNT::R6,  TNT::R7,
-    TNT::R8,  TNT::R9,  TNT::R10, TNT::R11,
-    TNT::R12, TNT::R13, TNT::R14, TNT::R15,
-    0
-  };
-  static const MCPhysReg CalleeSavedRegsIntrFP[] = {
-    TNT::R5,  TNT::R6,  TNT::R7,
-    TNT::R8,  TNT::R9,  TNT::R10, TNT::R11,
-    TNT::R12, TNT::R13, TNT::R14, TNT::R15,
-    0
-  };
-
-  // TODO: XXX
-  return CalleeSavedRegs;
-
-  //if (TFI->hasFP(*MF))
-  //  return (F->getCallingConv() == CallingConv::TNT_INTR ?
-  //          CalleeSavedRegsIntrFP : CalleeSavedRegsFP);
-  //else
-  //  return (F->getCallingConv() == CallingConv::TNT_INTR ?
-  //          CalleeSavedRegsIntr : CalleeSavedRegs);
+  bool IsIntr =
+      MF->getFunction()->getCallingConv() == CallingConv::MSP430_INTR;
+
+  // An interrupt may arrive anywhere, so handlers preserve every register
+  // they touch. Only the registers actually modified get saved; calls count
+  // as modifying whatever their register mask clobbers.
+  if (TFI->hasFP(*MF))
+    return IsIntr ? CSR_TNT_Intr_FP_SaveList : CSR_TNT_FP_SaveList;
+  return IsIntr ? CSR_TNT_Intr_SaveList : CSR_TNT_SaveList;
+}
 
+const uint32_t *
+TNTRegisterInfo::getCallPreservedMask(const MachineFunction &MF,
+                                      CallingConv::ID CC) const {
+  // FP is preserved across calls whether or not the callee uses it as the
+  // frame pointer.
+  return CC == CallingConv::MSP430_INTR ? CSR_TNT_Intr_RegMask
+                                        : CSR_TNT_RegMask;
 }
 
 BitVector TNTRegisterInfo::getReservedRegs(const MachineFunction &MF) const {
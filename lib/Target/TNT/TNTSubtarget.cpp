@@ -27,11 +27,36 @@ void TNTSubtarget::anchor() { }
 
 TNTSubtarget &
 TNTSubtarget::initializeSubtargetDependencies(StringRef CPU, StringRef FS) {
+  ExtendedInsts = false;
+  HWMult = false;
+
   ParseSubtargetFeatures("generic", FS);
   return *this;
 }
 
 TNTSubtarget::TNTSubtarget(const Triple &TT, const std::string &CPU,
-                                 const std::string &FS, const TargetMachine &TM)
-    : TNTGenSubtargetInfo(TT, CPU, FS), FrameLowering(),
-      InstrInfo(initializeSubtargetDependencies(CPU, FS)), TLInfo(TM, *this) {}
+                                 const std::string &FS, const TargetMachine &TM,
+                                 bool ForInterrupts)
+    : TNTGenSubtargetInfo(TT, CPU, FS), ForInterrupts(ForInterrupts),
+      FrameLowering(), InstrInfo(initializeSubtargetDependencies(CPU, FS)),
+      TLInfo(TM, *this) {}
+
+const CallLowering *TNTSubtarget::getCallLowering() const {
+  assert(GISel && "Access to GlobalISel APIs not set");
+  return GISel->getCallLowering();
+}
+
+const RegisterBankInfo *TNTSubtarget::getRegBankInfo() const {
+  assert(GISel && "Access to GlobalISel APIs not set");
+  return GISel->getRegBankInfo();
+}
+
+const LegalizerInfo *TNTSubtarget::getLegalizerInfo() const {
+  assert(GISel && "Access to GlobalISel APIs not set");
+  return GISel->getLegalizerInfo();
+}
+
+const InstructionSelector *TNTSubtarget::getInstructionSelector() const {
+  assert(GISel && "Access to GlobalISel APIs not set");
+  return GISel->getInstructionSelector();
+}
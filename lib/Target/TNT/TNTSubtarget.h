@@ -18,6 +18,7 @@
 #include "TNTISelLowering.h"
 #include "TNTInstrInfo.h"
 #include "TNTRegisterInfo.h"
+#include "llvm/CodeGen/GlobalISel/GISelAccessor.h"
 #include "llvm/CodeGen/SelectionDAGTargetInfo.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/Target/TargetSubtargetInfo.h"
@@ -32,24 +33,51 @@ class StringRef;
 class TNTSubtarget : public TNTGenSubtargetInfo {
   virtual void anchor();
   bool ExtendedInsts;
+  bool HWMult;
+  bool ForInterrupts;
   TNTFrameLowering FrameLowering;
   TNTInstrInfo InstrInfo;
   TNTTargetLowering TLInfo;
   SelectionDAGTargetInfo TSInfo;
+  /// Gather the accessor points to GlobalISel-related APIs.
+  /// This is used to avoid ifndefs spreading around while GISel is
+  /// an optional library.
+  std::unique_ptr<GISelAccessor> GISel;
 
 public:
   /// This constructor initializes the data members to match that
   /// of the specified triple.
   ///
   TNTSubtarget(const Triple &TT, const std::string &CPU,
-                  const std::string &FS, const TargetMachine &TM);
+                  const std::string &FS, const TargetMachine &TM,
+                  bool ForInterrupts = false);
 
   TNTSubtarget &initializeSubtargetDependencies(StringRef CPU, StringRef FS);
 
+  /// This object will take ownership of \p GISelAccessor.
+  void setGISelAccessor(GISelAccessor &GISel) {
+    this->GISel.reset(&GISel);
+  }
+
   /// ParseSubtargetFeatures - Parses features string setting specified
   /// subtarget options.  Definition of function is auto generated by tblgen.
   void ParseSubtargetFeatures(StringRef CPU, StringRef FS);
 
+  bool hasHWMult() const { return HWMult; }
+
+  /// Return true if this subtarget compiles interrupt handlers, which may
+  /// not touch state that the interrupted code owns.
+  bool isForInterrupts() const { return ForInterrupts; }
+
+  /// TNT has a scheduling model; use it to order instructions before
+  /// register allocation.
+  bool enableMachineScheduler() const override { return true; }
+
+  /// Let the DAG combiner use alias analysis to drop chain dependencies
+  /// between non-aliasing memory operations, so that copies and
+  /// read-modify-write updates fold into the memory-to-memory forms.
+  bool useAA() const override { return true; }
+
   const TargetFrameLowering *getFrameLowering() const override {
     return &FrameLowering;
   }
@@ -63,6 +91,10 @@ public:
   const SelectionDAGTargetInfo *getSelectionDAGInfo() const override {
     return &TSInfo;
   }
+  const CallLowering *getCallLowering() const override;
+  const RegisterBankInfo *getRegBankInfo() const override;
+  const LegalizerInfo *getLegalizerInfo() const override;
+  const InstructionSelector *getInstructionSelector() const override;
 };
 } // End llvm namespace
 
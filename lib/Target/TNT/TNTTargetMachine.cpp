@@ -13,17 +13,36 @@
 
 #include "TNTTargetMachine.h"
 #include "TNT.h"
+#include "TNTCallLowering.h"
+#include "TNTInstructionSelector.h"
+#include "TNTLegalizerInfo.h"
+#include "TNTRegisterBankInfo.h"
+#include "TNTTargetTransformInfo.h"
+#include "llvm/CodeGen/GlobalISel/IRTranslator.h"
+#include "llvm/CodeGen/GlobalISel/InstructionSelect.h"
+#include "llvm/CodeGen/GlobalISel/Legalizer.h"
+#include "llvm/CodeGen/GlobalISel/RegBankSelect.h"
 #include "llvm/CodeGen/Passes.h"
 #include "llvm/CodeGen/TargetLoweringObjectFileImpl.h"
 #include "llvm/CodeGen/TargetPassConfig.h"
 #include "llvm/IR/LegacyPassManager.h"
+#include "llvm/InitializePasses.h"
 #include "llvm/MC/MCAsmInfo.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/TargetRegistry.h"
 using namespace llvm;
 
+// With only twelve allocatable registers, knowing which of them a callee
+// really clobbers matters, so interprocedural register allocation is on by
+// default when optimizing.
+static cl::opt<bool>
+EnableTNTIPRA("tnt-enable-ipra", cl::Hidden, cl::init(true),
+              cl::desc("Enable interprocedural register allocation for TNT"));
+
 extern "C" void LLVMInitializeTNTTarget() {
   // Register the target.
   RegisterTargetMachine<TNTTargetMachine> X(TheTNTTarget);
+  initializeGlobalISel(*PassRegistry::getPassRegistry());
 }
 
 static Reloc::Model getEffectiveRelocModel(Optional<Reloc::Model> RM) {
@@ -32,6 +51,43 @@ static Reloc::Model getEffectiveRelocModel(Optional<Reloc::Model> RM) {
   return *RM;
 }
 
+#ifdef LLVM_BUILD_GLOBAL_ISEL
+namespace {
+struct TNTGISelActualAccessor : public GISelAccessor {
+  std::unique_ptr<CallLowering> CallLoweringInfo;
+  std::unique_ptr<RegisterBankInfo> RegBankInfo;
+  std::unique_ptr<LegalizerInfo> LegalInfo;
+  std::unique_ptr<InstructionSelector> InstSelector;
+  const CallLowering *getCallLowering() const override {
+    return CallLoweringInfo.get();
+  }
+  const RegisterBankInfo *getRegBankInfo() const override {
+    return RegBankInfo.get();
+  }
+  const LegalizerInfo *getLegalizerInfo() const override {
+    return LegalInfo.get();
+  }
+  const InstructionSelector *getInstructionSelector() const override {
+    return InstSelector.get();
+  }
+};
+} // End anonymous namespace.
+#endif
+
+static void initGISelAccessor(TNTSubtarget &ST) {
+#ifndef LLVM_BUILD_GLOBAL_ISEL
+  GISelAccessor *GISel = new GISelAccessor();
+#else
+  TNTGISelActualAccessor *GISel = new TNTGISelActualAccessor();
+  GISel->CallLoweringInfo.reset(new TNTCallLowering(*ST.getTargetLowering()));
+  GISel->LegalInfo.reset(new TNTLegalizerInfo());
+  auto *RBI = new TNTRegisterBankInfo(*ST.getRegisterInfo());
+  GISel->RegBankInfo.reset(RBI);
+  GISel->InstSelector.reset(new TNTInstructionSelector(ST, *RBI));
+#endif
+  ST.setGISelAccessor(*GISel);
+}
+
 TNTTargetMachine::TNTTargetMachine(const Target &T, const Triple &TT,
                                          StringRef CPU, StringRef FS,
                                          const TargetOptions &Options,
@@ -42,12 +98,33 @@ TNTTargetMachine::TNTTargetMachine(const Target &T, const Triple &TT,
                         Options, getEffectiveRelocModel(RM), CM, OL),
       TLOF(make_unique<TargetLoweringObjectFileELF>()),
       // FIXME: Check DataLayout string.
-      Subtarget(TT, CPU, FS, *this) {
+      Subtarget(TT, CPU, FS, *this),
+      IntrSubtarget(TT, CPU, FS, *this, /*ForInterrupts=*/true) {
+  if (EnableTNTIPRA && OL != CodeGenOpt::None)
+    this->Options.EnableIPRA = true;
   initAsmInfo();
+
+  initGISelAccessor(Subtarget);
+  initGISelAccessor(IntrSubtarget);
 }
 
 TNTTargetMachine::~TNTTargetMachine() {}
 
+const TNTSubtarget *
+TNTTargetMachine::getSubtargetImpl(const Function &F) const {
+  // Interrupt handlers get a subtarget of their own, so that code generation
+  // can keep them away from resources the interrupted code may be using.
+  if (F.getCallingConv() == CallingConv::MSP430_INTR)
+    return &IntrSubtarget;
+  return &Subtarget;
+}
+
+TargetIRAnalysis TNTTargetMachine::getTargetIRAnalysis() {
+  return TargetIRAnalysis([this](const Function &F) {
+    return TargetTransformInfo(TNTTTIImpl(this, F));
+  });
+}
+
 namespace {
 /// TNT Code Generator Pass Configuration Options.
 class TNTPassConfig : public TargetPassConfig {
@@ -60,7 +137,12 @@ public:
   }
 
   bool addInstSelector() override;
-  void addPreEmitPass() override;
+#ifdef LLVM_BUILD_GLOBAL_ISEL
+  bool addIRTranslator() override;
+  bool addLegalizeMachineIR() override;
+  bool addRegBankSelect() override;
+  bool addGlobalInstructionSelect() override;
+#endif
 };
 } // namespace
 
@@ -74,7 +156,21 @@ bool TNTPassConfig::addInstSelector() {
   return false;
 }
 
-void TNTPassConfig::addPreEmitPass() {
-  // Must run branch selection immediately preceding the asm printer.
-  addPass(createTNTBranchSelectionPass(), false);
+#ifdef LLVM_BUILD_GLOBAL_ISEL
+bool TNTPassConfig::addIRTranslator() {
+  addPass(new IRTranslator());
+  return false;
+}
+bool TNTPassConfig::addLegalizeMachineIR() {
+  addPass(new Legalizer());
+  return false;
+}
+bool TNTPassConfig::addRegBankSelect() {
+  addPass(new RegBankSelect());
+  return false;
+}
+bool TNTPassConfig::addGlobalInstructionSelect() {
+  addPass(new InstructionSelect());
+  return false;
 }
+#endif
@@ -26,6 +26,7 @@ namespace llvm {
 class TNTTargetMachine : public LLVMTargetMachine {
   std::unique_ptr<TargetLoweringObjectFile> TLOF;
   TNTSubtarget        Subtarget;
+  TNTSubtarget        IntrSubtarget;
 
 public:
   TNTTargetMachine(const Target &T, const Triple &TT, StringRef CPU,
@@ -34,11 +35,11 @@ public:
                       CodeGenOpt::Level OL);
   ~TNTTargetMachine() override;
 
-  const TNTSubtarget *getSubtargetImpl(const Function &F) const override {
-    return &Subtarget;
-  }
+  const TNTSubtarget *getSubtargetImpl(const Function &F) const override;
   TargetPassConfig *createPassConfig(PassManagerBase &PM) override;
 
+  TargetIRAnalysis getTargetIRAnalysis() override;
+
   TargetLoweringObjectFile *getObjFileLowering() const override {
     return TLOF.get();
   }
@@ -0,0 +1,180 @@
+//===-- TNTTargetTransformInfo.cpp - TNT specific TTI ---------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a TargetTransformInfo analysis pass specific to the
+// TNT target machine. It uses the target's detailed information to provide
+// more precise answers to certain TTI queries, while letting the target
+// independent and default TTI implementations handle the rest.
+//
+//===----------------------------------------------------------------------===//
+
+#include "TNTTargetTransformInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/CodeGen/BasicTTIImpl.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Target/TargetLowering.h"
+using namespace llvm;
+
+#define DEBUG_TYPE "tnttti"
+
+//===----------------------------------------------------------------------===//
+//
+// TNT cost model.
+//
+//===----------------------------------------------------------------------===//
+
+/// isCGConstant - Return true if Val comes from the constant generators and
+/// takes no extension word.
+static bool isCGConstant(int64_t Val) {
+  return Val == 0 || Val == 1 || Val == 2 || Val == 4 || Val == 8 ||
+         Val == -1;
+}
+
+int TNTTTIImpl::getIntImmCost(const APInt &Imm, Type *Ty) {
+  assert(Ty->isIntegerTy());
+
+  unsigned BitSize = Ty->getPrimitiveSizeInBits();
+  // There is no cost model for constants with a bit size of 0. Return TCC_Free
+  // here, so that constant hoisting will ignore this constant.
+  if (BitSize == 0)
+    return TTI::TCC_Free;
+
+  // Every word that is not a constant generator value needs a mov with an
+  // extension word.
+  int Cost = 0;
+  for (unsigned Shift = 0; Shift < BitSize; Shift += 16) {
+    APInt Word = Imm.lshr(Shift).sextOrTrunc(16);
+    if (!isCGConstant(Word.getSExtValue()))
+      Cost += TTI::TCC_Basic;
+  }
+  return Cost;
+}
+
+int TNTTTIImpl::getIntImmCost(unsigned Opcode, unsigned Idx, const APInt &Imm,
+                              Type *Ty) {
+  assert(Ty->isIntegerTy());
+
+  unsigned BitSize = Ty->getPrimitiveSizeInBits();
+  if (BitSize == 0)
+    return TTI::TCC_Free;
+
+  switch (Opcode) {
+  default:
+    break;
+  case Instruction::Add:
+  case Instruction::Sub:
+  case Instruction::And:
+  case Instruction::Or:
+  case Instruction::Xor:
+  case Instruction::ICmp:
+  case Instruction::Select:
+  case Instruction::Ret:
+  case Instruction::Shl:
+  case Instruction::LShr:
+  case Instruction::AShr:
+    // Any of these takes the constant as an #imm source operand.
+    return TTI::TCC_Free;
+  case Instruction::Store:
+    // mov #imm, X(Rn) takes the constant directly, but is not the address.
+    if (Idx == 0)
+      return TTI::TCC_Free;
+    break;
+  case Instruction::Mul:
+  case Instruction::UDiv:
+  case Instruction::SDiv:
+  case Instruction::URem:
+  case Instruction::SRem:
+    // Constant operands are expanded into shifts and adds, see
+    // TNTTargetLowering::PerformDAGCombine.
+    if (Idx == 1)
+      return TTI::TCC_Free;
+    break;
+  }
+
+  return getIntImmCost(Imm, Ty);
+}
+
+unsigned TNTTTIImpl::getOperationCost(unsigned Opcode, Type *Ty, Type *OpTy) {
+  switch (Opcode) {
+  default:
+    break;
+  case Instruction::Mul:
+    // Without the hardware multiplier this is a call to a shift-and-add loop.
+    if (!TLI->isOperationLegal(ISD::MUL, TLI->getValueType(DL, Ty, true)))
+      return TTI::TCC_Expensive;
+    break;
+  case Instruction::Shl:
+  case Instruction::LShr:
+  case Instruction::AShr:
+    // Only single-bit shifts are native.
+    if (Ty->isIntegerTy() && Ty->getPrimitiveSizeInBits() > 16)
+      return TTI::TCC_Expensive;
+    break;
+  }
+
+  return BaseT::getOperationCost(Opcode, Ty, OpTy);
+}
+
+int TNTTTIImpl::getArithmeticInstrCost(
+    unsigned Opcode, Type *Ty, TTI::OperandValueKind Op1Info,
+    TTI::OperandValueKind Op2Info, TTI::OperandValueProperties Opd1PropInfo,
+    TTI::OperandValueProperties Opd2PropInfo) {
+  if (Ty->isVectorTy() || !Ty->isIntegerTy())
+    return BaseT::getArithmeticInstrCost(Opcode, Ty, Op1Info, Op2Info,
+                                         Opd1PropInfo, Opd2PropInfo);
+
+  // Number of 16-bit words the operation is split into.
+  std::pair<int, MVT> LT = TLI->getTypeLegalizationCost(DL, Ty);
+  int ISD = TLI->InstructionOpcodeToISD(Opcode);
+  bool ConstOp2 = Op2Info != TTI::OK_AnyValue;
+  bool Pow2Op2 = ConstOp2 && Opd2PropInfo == TTI::OP_PowerOf2;
+
+  switch (ISD) {
+  default:
+    break;
+  case ISD::MUL:
+    if (TLI->isOperationLegal(ISD::MUL, LT.second))
+      return 4 * LT.first * LT.first;
+    // Constants are expanded into a few shifts and adds; anything else is a
+    // library call looping over the bits of the multiplier.
+    if (ConstOp2)
+      return 4 * LT.first;
+    return 16 * LT.first * LT.first;
+  case ISD::SDIV:
+  case ISD::UDIV:
+  case ISD::SREM:
+  case ISD::UREM:
+    if (Pow2Op2)
+      return 2 * LT.first;
+    if (ConstOp2 && LT.first == 1)
+      return 12;
+    return 32 * LT.first * LT.first;
+  case ISD::SHL:
+  case ISD::SRL:
+  case ISD::SRA:
+    // A constant shift is a handful of one-bit steps or a byte swap; a
+    // variable one tests each bit of the amount. Wider types shift through
+    // the carry word by word.
+    if (ConstOp2)
+      return 2 * LT.first;
+    return 8 * LT.first;
+  }
+
+  return BaseT::getArithmeticInstrCost(Opcode, Ty, Op1Info, Op2Info,
+                                       Opd1PropInfo, Opd2PropInfo);
+}
+
+void TNTTTIImpl::getUnrollingPreferences(Loop *L,
+                                         TTI::UnrollingPreferences &UP) {
+  // Code lives in small flash and there is no pipeline or loop buffer to
+  // feed: only fully unroll loops that become tiny, never partially.
+  UP.Threshold = 60;
+  UP.OptSizeThreshold = 0;
+  UP.Partial = UP.Runtime = false;
+}
@@ -0,0 +1,93 @@
+//===-- TNTTargetTransformInfo.h - TNT specific TTI -------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a TargetTransformInfo::Concept conforming object specific to the
+// TNT target machine. It uses the target's detailed information to provide
+// more precise answers to certain TTI queries, while letting the target
+// independent and default TTI implementations handle the rest.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIB_TARGET_TNT_TNTTARGETTRANSFORMINFO_H
+#define LLVM_LIB_TARGET_TNT_TNTTARGETTRANSFORMINFO_H
+
+#include "TNT.h"
+#include "TNTTargetMachine.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/CodeGen/BasicTTIImpl.h"
+#include "llvm/Target/TargetLowering.h"
+
+namespace llvm {
+
+class TNTTTIImpl : public BasicTTIImplBase<TNTTTIImpl> {
+  typedef BasicTTIImplBase<TNTTTIImpl> BaseT;
+  typedef TargetTransformInfo TTI;
+  friend BaseT;
+
+  const TNTSubtarget *ST;
+  const TNTTargetLowering *TLI;
+
+  const TNTSubtarget *getST() const { return ST; }
+  const TNTTargetLowering *getTLI() const { return TLI; }
+
+public:
+  explicit TNTTTIImpl(const TNTTargetMachine *TM, const Function &F)
+      : BaseT(TM, F.getParent()->getDataLayout()), ST(TM->getSubtargetImpl(F)),
+        TLI(ST->getTargetLowering()) {}
+
+  TNTTTIImpl(const TNTTTIImpl &Arg)
+      : BaseT(static_cast<const BaseT &>(Arg)), ST(Arg.ST), TLI(Arg.TLI) {}
+  TNTTTIImpl(TNTTTIImpl &&Arg)
+      : BaseT(std::move(static_cast<BaseT &>(Arg))), ST(Arg.ST), TLI(Arg.TLI) {}
+
+  /// \name Scalar TTI Implementations
+  /// @{
+
+  // Addressing modes come from TNTTargetLowering::isLegalAddressingMode: a
+  // register or a symbol plus a 16-bit index, never a scaled register. Loop
+  // strength reduction then walks arrays with pointer induction variables,
+  // which isel turns into @Rn+ post-increment operands.
+
+  TTI::PopcntSupportKind getPopcntSupport(unsigned TyWidth) {
+    return TTI::PSK_Software;
+  }
+
+  int getIntImmCost(const APInt &Imm, Type *Ty);
+  int getIntImmCost(unsigned Opcode, unsigned Idx, const APInt &Imm, Type *Ty);
+  using BaseT::getIntImmCost;
+
+  unsigned getOperationCost(unsigned Opcode, Type *Ty, Type *OpTy);
+
+  void getUnrollingPreferences(Loop *L, TTI::UnrollingPreferences &UP);
+
+  /// @}
+
+  /// \name Vector TTI Implementations
+  /// @{
+
+  unsigned getNumberOfRegisters(bool Vector) {
+    // r4 - r15, r4 is taken when a frame pointer is needed.
+    return Vector ? 0 : 12;
+  }
+
+  unsigned getRegisterBitWidth(bool Vector) { return Vector ? 0 : 16; }
+
+  int getArithmeticInstrCost(
+      unsigned Opcode, Type *Ty,
+      TTI::OperandValueKind Opd1Info = TTI::OK_AnyValue,
+      TTI::OperandValueKind Opd2Info = TTI::OK_AnyValue,
+      TTI::OperandValueProperties Opd1PropInfo = TTI::OP_None,
+      TTI::OperandValueProperties Opd2PropInfo = TTI::OP_None);
+
+  /// @}
+};
+
+} // end namespace llvm
+
+#endif // LLVM_LIB_TARGET_TNT_TNTTARGETTRANSFORMINFO_H
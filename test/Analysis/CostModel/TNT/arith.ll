@@ -0,0 +1,23 @@
+; RUN: opt < %s -cost-model -analyze -mtriple=tnt | FileCheck %s
+; RUN: opt < %s -cost-model -analyze -mtriple=tnt -mattr=+hwmult \
+; RUN:   | FileCheck -check-prefix=HWMULT %s
+
+define void @arith(i16 %a, i16 %b, i32 %c, i32 %d) {
+; CHECK: cost of 1 {{.*}} add i16
+; CHECK: cost of 2 {{.*}} add i32
+  %add16 = add i16 %a, %b
+  %add32 = add i32 %c, %d
+
+; CHECK: cost of 16 {{.*}} mul i16 %a, %b
+; CHECK: cost of 64 {{.*}} mul i32
+; HWMULT: cost of 4 {{.*}} mul i16 %a, %b
+  %mul16 = mul i16 %a, %b
+  %mul32 = mul i32 %c, %d
+
+; CHECK: cost of 32 {{.*}} udiv i16 %a, %b
+  %div16 = udiv i16 %a, %b
+
+; CHECK: cost of 8 {{.*}} shl i16 %a, %b
+  %shl16 = shl i16 %a, %b
+  ret void
+}
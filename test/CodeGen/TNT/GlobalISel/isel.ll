@@ -0,0 +1,96 @@
+; RUN: llc -mtriple=tnt -O0 -global-isel -stop-after=irtranslator -verify-machineinstrs < %s -o - | FileCheck %s --check-prefix=MIR
+; RUN: llc -mtriple=tnt -O0 -global-isel -verify-machineinstrs < %s | FileCheck %s
+; REQUIRES: global-isel
+
+; Check that simple functions go all the way through GlobalISel.
+
+; MIR-LABEL: name: add16
+; MIR:      %0(16) = COPY %r15
+; MIR-NEXT: %1(16) = COPY %r14
+; MIR-NEXT: %2(16) = G_ADD i16 %0, %1
+; MIR-NEXT: %r15 = COPY %2
+; MIR-NEXT: RET implicit %r15
+; CHECK-LABEL: add16:
+; CHECK:      add.w r14, r15
+; CHECK-NEXT: ret
+define i16 @add16(i16 %a, i16 %b) {
+  %r = add i16 %a, %b
+  ret i16 %r
+}
+
+; i8 arguments arrive in the low byte of the promoted registers.
+; MIR-LABEL: name: sub8
+; MIR:      %0(8) = COPY %r15b
+; MIR-NEXT: %1(8) = COPY %r14b
+; MIR-NEXT: %2(8) = G_SUB i8 %0, %1
+; MIR-NEXT: %r15b = COPY %2
+; CHECK-LABEL: sub8:
+; CHECK:      sub.b r14, r15
+; CHECK-NEXT: ret
+define i8 @sub8(i8 %a, i8 %b) {
+  %r = sub i8 %a, %b
+  ret i8 %r
+}
+
+; Constants are materialized in the entry block and folded into their users.
+; MIR-LABEL: name: andimm
+; MIR:      %1(16) = G_CONSTANT i16 255
+; MIR:      %2(16) = G_AND i16 %0, %1
+; CHECK-LABEL: andimm:
+; CHECK-NOT:  mov
+; CHECK:      and.w #255, r15
+; CHECK-NEXT: ret
+define i16 @andimm(i16 %a) {
+  %r = and i16 %a, 255
+  ret i16 %r
+}
+
+; CHECK-LABEL: orcomm:
+; CHECK-NOT:  mov
+; CHECK:      bis.w #1, r15
+; CHECK-NEXT: ret
+define i16 @orcomm(i16 %a) {
+  %r = or i16 1, %a
+  ret i16 %r
+}
+
+; The first operand of a subtraction cannot be an immediate.
+; CHECK-LABEL: subcst:
+; CHECK:      mov.w #5, [[REG:r[0-9]+]]
+; CHECK-NEXT: sub.w r15, [[REG]]
+; CHECK-NEXT: mov.w [[REG]], r15
+define i16 @subcst(i16 %a) {
+  %r = sub i16 5, %a
+  ret i16 %r
+}
+
+; CHECK-LABEL: cst:
+; CHECK:      mov.w #42, r15
+; CHECK-NEXT: ret
+define i16 @cst() {
+  ret i16 42
+}
+
+; CHECK-LABEL: xorbr:
+; CHECK:      xor.b r14, r15
+; CHECK:      jmp .LBB6_1
+; CHECK:      .LBB6_1:
+; CHECK:      add.b
+; CHECK:      add.b #3,
+; CHECK:      ret
+define i8 @xorbr(i8 %a, i8 %b, i8 %c) {
+entry:
+  %x = xor i8 %a, %b
+  br label %next
+next:
+  %y = add i8 %x, %c
+  %z = add i8 %y, 3
+  ret i8 %z
+}
+
+; CHECK-LABEL: retvoid:
+; CHECK-NOT:  mov
+; CHECK:      ret
+define void @retvoid() {
+  ret void
+}
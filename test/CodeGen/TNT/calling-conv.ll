@@ -0,0 +1,74 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+
+; The first four i16 words of arguments and results live in R15..R12. i8
+; values take a whole register, i32 values a register pair with the high
+; word in the lower-numbered register. Only what does not fit goes on the
+; stack.
+
+define i8 @add8(i8 %a, i8 %b) {
+; CHECK-LABEL: add8:
+; CHECK:       add.b r14, r15
+; CHECK:       ret
+  %s = add i8 %a, %b
+  ret i8 %s
+}
+
+define i8 @call8(i8 %a) {
+; CHECK-LABEL: call8:
+; CHECK-NOT:   (r1)
+; CHECK:       mov.w #3, r14
+; CHECK-NEXT:  call #add8
+; CHECK-NEXT:  ret
+  %r = call i8 @add8(i8 %a, i8 3)
+  ret i8 %r
+}
+
+define i32 @add32(i32 %a, i32 %b) {
+; CHECK-LABEL: add32:
+; CHECK:       add.w r12, r14
+; CHECK-NEXT:  addc.w r13, r15
+; CHECK-NEXT:  ret
+  %s = add i32 %a, %b
+  ret i32 %s
+}
+
+define i32 @call32(i32 %a) {
+; CHECK-LABEL: call32:
+; CHECK-NOT:   (r1)
+; CHECK:       call #add32
+; CHECK-NEXT:  ret
+  %r = call i32 @add32(i32 %a, i32 7)
+  ret i32 %r
+}
+
+; The fifth i8 is promoted to a full stack slot.
+define i8 @stack8(i8 %a, i8 %b, i8 %c, i8 %d, i8 zeroext %e) {
+; CHECK-LABEL: stack8:
+; CHECK:       mov.w 2(r1), r12
+; CHECK-NEXT:  add.b r12, r15
+  %s = add i8 %a, %e
+  ret i8 %s
+}
+
+define i8 @callstack8(i8 %a) {
+; CHECK-LABEL: callstack8:
+; CHECK:       mov.w #4, 0(r1)
+; CHECK-NEXT:  call #stack8
+  %r = call i8 @stack8(i8 %a, i8 1, i8 2, i8 3, i8 zeroext 4)
+  ret i8 %r
+}
+
+; Variadic arguments are always passed on the stack.
+declare void @va(i16, ...)
+
+define void @callva(i8 %a, i32 %b) {
+; CHECK-LABEL: callva:
+; CHECK:       sub.w #8, r1
+; CHECK-DAG:   mov.w r14, 6(r1)
+; CHECK-DAG:   mov.w r13, 4(r1)
+; CHECK-DAG:   mov.w r15, 2(r1)
+; CHECK-DAG:   mov.w #1, 0(r1)
+; CHECK:       call #va
+  call void (i16, ...) @va(i16 1, i8 %a, i32 %b)
+  ret void
+}
@@ -0,0 +1,88 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+
+; Comparisons whose flags are already set by the instruction computing the
+; value, or by an identical subtraction, are removed.
+
+@g = global i16 0
+
+declare void @foo()
+
+; CHECK-LABEL: subz:
+; CHECK: sub.w
+; CHECK-NOT: cmp
+; CHECK: jne
+define i16 @subz(i16 %a, i16 %b) nounwind {
+entry:
+  %s = sub i16 %a, %b
+  %c = icmp eq i16 %s, 0
+  br i1 %c, label %t, label %f
+t:
+  tail call void @foo()
+  ret i16 0
+f:
+  ret i16 %s
+}
+
+; CHECK-LABEL: andneg:
+; CHECK: and.w
+; CHECK-NOT: cmp
+; CHECK: j{{ge|l|n}}
+define i16 @andneg(i16 %a, i16 %b) nounwind {
+entry:
+  %s = and i16 %a, %b
+  %c = icmp slt i16 %s, 0
+  br i1 %c, label %t, label %f
+t:
+  tail call void @foo()
+  ret i16 0
+f:
+  ret i16 %s
+}
+
+; CHECK-LABEL: subcmp:
+; CHECK: sub.w
+; CHECK-NOT: cmp
+; CHECK: j{{lo|hs}}
+define i16 @subcmp(i16 %a, i16 %b) nounwind {
+entry:
+  %s = sub i16 %a, %b
+  store i16 %s, i16* @g
+  %c = icmp ult i16 %a, %b
+  br i1 %c, label %t, label %f
+t:
+  tail call void @foo()
+  ret i16 0
+f:
+  ret i16 %s
+}
+
+; The carry of the addition is not that of a comparison with zero.
+; CHECK-LABEL: addult:
+; CHECK: add.w
+; CHECK: cmp.w
+define i16 @addult(i16 %a, i16 %b) nounwind {
+entry:
+  %s = add i16 %a, %b
+  %c = icmp ult i16 %s, 3
+  br i1 %c, label %t, label %f
+t:
+  tail call void @foo()
+  ret i16 0
+f:
+  ret i16 %s
+}
+
+; CHECK-LABEL: addslt:
+; CHECK: add.w
+; CHECK: cmp.w
+define i16 @addslt(i16 %a, i16 %b) nounwind {
+entry:
+  %s = add i16 %a, %b
+  %c = icmp slt i16 %s, 0
+  br i1 %c, label %t, label %f
+t:
+  tail call void @foo()
+  ret i16 0
+f:
+  ret i16 %s
+}
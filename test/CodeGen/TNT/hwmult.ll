@@ -0,0 +1,75 @@
+; RUN: llc -mtriple=tnt -mattr=+hwmult < %s | FileCheck %s
+; RUN: llc -mtriple=tnt < %s | FileCheck %s --check-prefix=NOHW
+
+; Multiplications go through the memory-mapped multiplier: MPY at 304,
+; MPYS at 306, OP2 at 312, RESLO at 314 and RESHI at 316.
+
+define i16 @mul(i16 %a, i16 %b) nounwind {
+; CHECK-LABEL: mul:
+; CHECK:      mov.w r15, &304
+; CHECK-NEXT: mov.w r14, &312
+; CHECK-NEXT: mov.w &314, r15
+  %r = mul i16 %a, %b
+  ret i16 %r
+}
+
+define void @mul8(i8 %a, i8 %b, i8* %p) nounwind {
+; CHECK-LABEL: mul8:
+; CHECK:      mov.w r15, &304
+; CHECK-NEXT: mov.w r14, &312
+; CHECK-NEXT: mov.w &314, [[R:r[0-9]+]]
+; CHECK-NEXT: mov.b [[R]], 0(r13)
+  %r = mul i8 %a, %b
+  store i8 %r, i8* %p
+  ret void
+}
+
+define i32 @mul32(i32 %a, i32 %b) nounwind {
+; CHECK-LABEL: mul32:
+; CHECK-NOT:  call
+; CHECK:      &316
+; CHECK-NOT:  call
+; CHECK:      ret
+  %r = mul i32 %a, %b
+  ret i32 %r
+}
+
+define i16 @udiv(i16 %a) nounwind {
+; CHECK-LABEL: udiv:
+; CHECK:      mov.w #-13107, [[M:r[0-9]+]]
+; CHECK-NEXT: mov.w r15, &304
+; CHECK-NEXT: mov.w [[M]], &312
+; CHECK-NEXT: mov.w &316, r15
+  %r = udiv i16 %a, 10
+  ret i16 %r
+}
+
+define i16 @sdiv(i16 %a) nounwind {
+; CHECK-LABEL: sdiv:
+; CHECK:      mov.w r15, &306
+; CHECK:      mov.w &316
+  %r = sdiv i16 %a, 10
+  ret i16 %r
+}
+
+; An interrupt handler may have interrupted a multiplication in progress, so
+; it multiplies in software and leaves the multiplier alone.
+@x = global i16 0
+@y = global i16 0
+
+define msp430_intrcc void @isr() {
+; CHECK-LABEL: isr:
+; CHECK-NOT:  &30{{[46]}}
+; CHECK-NOT:  &31{{[246]}}
+; CHECK:      call #__mulhi3{{$}}
+; CHECK-NOT:  &30{{[46]}}
+; CHECK-NOT:  &31{{[246]}}
+; CHECK:      reti
+; NOHW-LABEL: isr:
+; NOHW:       call #__mulhi3{{$}}
+  %a = load volatile i16, i16* @x
+  %b = load volatile i16, i16* @y
+  %r = mul i16 %a, %b
+  store volatile i16 %r, i16* @x
+  ret void
+}
@@ -0,0 +1,71 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+
+; Interrupt handlers return with reti and preserve every register they
+; modify, including the argument registers, but nothing else. Leaf handlers
+; never set up a frame pointer.
+
+@cnt = global i16 0
+@flags = global i16 0
+
+declare void @work(i16)
+
+define msp430_intrcc void @leaf() #0 {
+; CHECK-LABEL: leaf:
+; CHECK-NOT:   r4
+; CHECK:       push.w r13
+; CHECK-NEXT:  push.w r12
+; CHECK-NEXT:  mov.w &cnt, r12
+; CHECK-NOT:   push
+; CHECK:       pop.w r12
+; CHECK-NEXT:  pop.w r13
+; CHECK-NEXT:  reti
+  %v = load volatile i16, i16* @cnt
+  %f = load volatile i16, i16* @flags
+  %x = xor i16 %v, %f
+  %a = and i16 %x, %v
+  store volatile i16 %a, i16* @cnt
+  store volatile i16 %x, i16* @flags
+  ret void
+}
+
+define msp430_intrcc void @empty() #0 {
+; CHECK-LABEL: empty:
+; CHECK-NOT:   push
+; CHECK:       reti
+  ret void
+}
+
+; Calls clobber R12-R15, so they are saved around the whole handler.
+define msp430_intrcc void @nonleaf() #0 {
+; CHECK-LABEL: nonleaf:
+; CHECK:       push.w r4
+; CHECK-NEXT:  mov.w r1, r4
+; CHECK-NEXT:  push.w r15
+; CHECK-NEXT:  push.w r14
+; CHECK-NEXT:  push.w r13
+; CHECK-NEXT:  push.w r12
+; CHECK-NOT:   push
+; CHECK:       call #work
+; CHECK:       pop.w r12
+; CHECK-NEXT:  pop.w r13
+; CHECK-NEXT:  pop.w r14
+; CHECK-NEXT:  pop.w r15
+; CHECK-NEXT:  pop.w r4
+; CHECK-NEXT:  reti
+  %v = load volatile i16, i16* @cnt
+  call void @work(i16 %v)
+  ret void
+}
+
+; Ordinary functions still only save R4-R11.
+define void @plain(i16 %a) {
+; CHECK-LABEL: plain:
+; CHECK-NOT:   push
+; CHECK:       ret
+  %v = load volatile i16, i16* @cnt
+  %s = add i16 %v, %a
+  store volatile i16 %s, i16* @cnt
+  ret void
+}
+
+attributes #0 = { "no-frame-pointer-elim"="true" }
@@ -0,0 +1,84 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+; RUN: llc < %s -mtriple=tnt -tnt-enable-ipra=false \
+; RUN:   | FileCheck -check-prefix=NOIPRA %s
+
+; Calls carry a register mask. With interprocedural register allocation the
+; mask of a call to a function compiled earlier lists only the registers it
+; really clobbers, so callers keep values in argument registers across it.
+
+define internal i16 @leaf(i16 %a) nounwind noinline {
+  %r = add i16 %a, 1
+  ret i16 %r
+}
+
+declare i16 @ext(i16)
+
+define i16 @caller(i16 %a, i16 %b) nounwind {
+; CHECK-LABEL: caller:
+; CHECK-NOT:  push
+; CHECK:      call #leaf
+; CHECK-NEXT: mov.w r15, r12
+; CHECK-NEXT: call #leaf
+; CHECK-NEXT: add.w r12, r15
+; CHECK-NEXT: add.w r14, r15
+; CHECK-NEXT: ret
+
+; NOIPRA-LABEL: caller:
+; NOIPRA:       push.w r11
+; NOIPRA:       push.w r10
+  %x = call i16 @leaf(i16 %a)
+  %y = call i16 @leaf(i16 %x)
+  %s = add i16 %x, %y
+  %r = add i16 %s, %b
+  ret i16 %r
+}
+
+; Nothing is known about external functions.
+define i16 @caller_ext(i16 %a, i16 %b) nounwind {
+; CHECK-LABEL: caller_ext:
+; CHECK:      push.w r11
+; CHECK:      mov.w r14, r11
+; CHECK:      call #ext
+; CHECK:      add.w r11, r15
+  %x = call i16 @ext(i16 %a)
+  %r = add i16 %x, %b
+  ret i16 %r
+}
+
+; A weak function may be replaced at link time by a body that clobbers more
+; registers than the one compiled here, so its usage is not propagated.
+define weak i16 @weak_leaf(i16 %a) nounwind noinline {
+  %r = add i16 %a, 1
+  ret i16 %r
+}
+
+define i16 @caller_weak(i16 %a, i16 %b) nounwind {
+; CHECK-LABEL: caller_weak:
+; CHECK:      push.w r11
+; CHECK:      mov.w r14, r11
+; CHECK:      call #weak_leaf
+; CHECK:      add.w r11, r15
+  %x = call i16 @weak_leaf(i16 %a)
+  %r = add i16 %x, %b
+  ret i16 %r
+}
+
+@g = global i16 0
+
+; An interrupt handler only saves what its callees clobber.
+define msp430_intrcc void @isr() {
+; CHECK-LABEL: isr:
+; CHECK:      push.w r15
+; CHECK-NEXT: mov.w &g, r15
+; CHECK-NEXT: call #leaf
+; CHECK-NEXT: mov.w r15, &g
+; CHECK-NEXT: pop.w r15
+; CHECK-NEXT: reti
+
+; NOIPRA-LABEL: isr:
+; NOIPRA:       push.w r12
+  %v = load volatile i16, i16* @g
+  %x = call i16 @leaf(i16 %v)
+  store volatile i16 %x, i16* @g
+  ret void
+}
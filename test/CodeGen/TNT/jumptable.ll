@@ -0,0 +1,68 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+; RUN: llc < %s -mtriple=tnt -filetype=obj -o - | llvm-readobj -r - \
+; RUN:   | FileCheck -check-prefix=RELOC %s
+
+; Dense switches dispatch through a table of block addresses in .rodata.
+; The index is scaled with a shift, not a multiply.
+
+declare void @f0()
+declare void @f1()
+declare void @f2()
+declare void @f3()
+declare void @f4()
+
+; CHECK-LABEL: sw:
+; CHECK:      cmp.w #6, r15
+; CHECK-NEXT: jhs
+; CHECK-NOT:  call
+; CHECK:      rla.w r15
+; CHECK-NEXT: br .LJTI0_0(r15)
+; CHECK:      .section .rodata,"a",@progbits
+; CHECK-NEXT: .p2align 1
+; CHECK-NEXT: .LJTI0_0:
+; CHECK-NEXT: .short .LBB0_{{[0-9]+}}
+; CHECK-NEXT: .short .LBB0_{{[0-9]+}}
+; CHECK-NEXT: .short .LBB0_{{[0-9]+}}
+; CHECK-NEXT: .short .LBB0_{{[0-9]+}}
+; CHECK-NEXT: .short .LBB0_{{[0-9]+}}
+; CHECK-NEXT: .short .LBB0_{{[0-9]+}}
+
+; RELOC:      Section ({{[0-9]+}}) .rela.text {
+; RELOC:        R_MSP430_16_BYTE .rodata 0x0
+; RELOC:      Section ({{[0-9]+}}) .rela.rodata {
+; RELOC-NEXT:   0x0 R_MSP430_16 .text
+; RELOC-NEXT:   0x2 R_MSP430_16 .text
+; RELOC-NEXT:   0x4 R_MSP430_16 .text
+; RELOC-NEXT:   0x6 R_MSP430_16 .text
+; RELOC-NEXT:   0x8 R_MSP430_16 .text
+; RELOC-NEXT:   0xA R_MSP430_16 .text
+; RELOC-NEXT: }
+
+define void @sw(i16 %x) nounwind {
+entry:
+  switch i16 %x, label %def [
+    i16 0, label %b0
+    i16 1, label %b1
+    i16 2, label %b2
+    i16 3, label %b3
+    i16 4, label %b4
+    i16 5, label %b2
+  ]
+b0:
+  call void @f0()
+  br label %def
+b1:
+  call void @f1()
+  br label %def
+b2:
+  call void @f2()
+  br label %def
+b3:
+  call void @f3()
+  br label %def
+b4:
+  call void @f4()
+  br label %def
+def:
+  ret void
+}
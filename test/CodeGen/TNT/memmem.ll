@@ -0,0 +1,90 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+
+; Copies and read-modify-write updates select the memory-to-memory forms.
+; Alias analysis in the DAG combiner takes stores off the chains of loads
+; they cannot clobber, so every load of a copy folds into its store.
+
+%struct = type { i16, i16, i16 }
+
+@x = global %struct zeroinitializer
+@y = global %struct zeroinitializer
+@a = global i16 0
+@b = global i16 0
+@port = external global i8
+
+define void @global_copy() nounwind {
+; CHECK-LABEL: global_copy:
+; CHECK:      mov.w &x+4, &y+4
+; CHECK-NEXT: mov.w &x+2, &y+2
+; CHECK-NEXT: mov.w &x, &y
+; CHECK-NEXT: ret
+  %v = load %struct, %struct* @x
+  store %struct %v, %struct* @y
+  ret void
+}
+
+define void @noalias_copy(%struct* noalias %p, %struct* noalias %q) nounwind {
+; CHECK-LABEL: noalias_copy:
+; CHECK:      mov.w 4(r15), 4(r14)
+; CHECK-NEXT: mov.w 2(r15), 2(r14)
+; CHECK-NEXT: mov.w 0(r15), 0(r14)
+; CHECK-NEXT: ret
+  %v = load %struct, %struct* %p
+  store %struct %v, %struct* %q
+  ret void
+}
+
+; Without noalias both loads must stay ahead of the first store.
+define void @may_alias_copy(i16* %p, i16* %q) nounwind {
+; CHECK-LABEL: may_alias_copy:
+; CHECK:      mov.w 0(r15), [[R:r[0-9]+]]
+; CHECK-NEXT: mov.w 2(r15), 2(r14)
+; CHECK-NEXT: mov.w [[R]], 0(r14)
+  %a = load i16, i16* %p
+  %p1 = getelementptr i16, i16* %p, i16 1
+  %b = load i16, i16* %p1
+  store i16 %a, i16* %q
+  %q1 = getelementptr i16, i16* %q, i16 1
+  store i16 %b, i16* %q1
+  ret void
+}
+
+define void @add_global() nounwind {
+; CHECK-LABEL: add_global:
+; CHECK:      add.w &a, &b
+; CHECK-NEXT: ret
+  %v = load i16, i16* @a
+  %w = load i16, i16* @b
+  %s = add i16 %w, %v
+  store i16 %s, i16* @b
+  ret void
+}
+
+define void @peripheral(i8 %m) nounwind {
+; CHECK-LABEL: peripheral:
+; CHECK:      xor.b r15, &port
+; CHECK-NEXT: and.b #-2, &port
+; CHECK-NEXT: bis.b #16, &port
+; CHECK-NEXT: ret
+  %v = load volatile i8, i8* @port
+  %x = xor i8 %v, %m
+  store volatile i8 %x, i8* @port
+  %w = load volatile i8, i8* @port
+  %y = and i8 %w, -2
+  store volatile i8 %y, i8* @port
+  %u = load volatile i8, i8* @port
+  %z = or i8 %u, 16
+  store volatile i8 %z, i8* @port
+  ret void
+}
+
+define void @high_byte() nounwind {
+; CHECK-LABEL: high_byte:
+; CHECK:      mov.b &a+1, &port
+; CHECK-NEXT: ret
+  %v = load i16, i16* @a
+  %s = lshr i16 %v, 8
+  %t = trunc i16 %s to i8
+  store i8 %t, i8* @port
+  ret void
+}
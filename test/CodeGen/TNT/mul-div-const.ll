@@ -0,0 +1,89 @@
+; RUN: llc -mtriple=tnt < %s | FileCheck %s
+
+; Multiplication and division by constants are done with shifts and adds
+; instead of library calls when that is cheap enough.
+
+define i16 @mul10(i16 %a) nounwind {
+; CHECK-LABEL: mul10:
+; CHECK-NOT: call
+; CHECK:     add.w r15, r15
+; CHECK:     add.w [[T:r[0-9]+]], [[T]]
+; CHECK:     add.w [[T]], [[T]]
+; CHECK:     add.w r15, [[T]]
+; CHECK-NOT: call
+; CHECK:     ret
+  %r = mul i16 %a, 10
+  ret i16 %r
+}
+
+define i16 @mul7(i16 %a) nounwind {
+; CHECK-LABEL: mul7:
+; CHECK-NOT: call
+; CHECK:     sub.w r15,
+; CHECK:     ret
+  %r = mul i16 %a, 7
+  ret i16 %r
+}
+
+define i16 @mulm3(i16 %a) nounwind {
+; CHECK-LABEL: mulm3:
+; CHECK:      mov.w r15, [[T:r[0-9]+]]
+; CHECK-NEXT: add.w [[T]], [[T]]
+; CHECK-NEXT: add.w [[T]], [[T]]
+; CHECK-NEXT: sub.w [[T]], r15
+; CHECK-NEXT: ret
+  %r = mul i16 %a, -3
+  ret i16 %r
+}
+
+define i32 @mul32(i32 %a) nounwind {
+; CHECK-LABEL: mul32:
+; CHECK-NOT: call
+; CHECK:     add.w r14, r14
+; CHECK-NEXT: addc.w r15, r15
+; CHECK-NOT: call
+; CHECK:     ret
+  %r = mul i32 %a, 10
+  ret i32 %r
+}
+
+; Too many terms: keep the libcall.
+define i16 @mul12345(i16 %a) nounwind {
+; CHECK-LABEL: mul12345:
+; CHECK: call #__mulhi3hw_noint
+  %r = mul i16 %a, 12345
+  ret i16 %r
+}
+
+define i16 @mul10_optsize(i16 %a) nounwind optsize {
+; CHECK-LABEL: mul10_optsize:
+; CHECK: call #__mulhi3hw_noint
+  %r = mul i16 %a, 10
+  ret i16 %r
+}
+
+define i16 @udiv7(i16 %a) nounwind {
+; CHECK-LABEL: udiv7:
+; CHECK-NOT: call
+; CHECK:     addc.w
+; CHECK-NOT: call
+; CHECK:     ret
+  %r = udiv i16 %a, 7
+  ret i16 %r
+}
+
+define void @udiv8(i8 %a, i8* %p) nounwind {
+; CHECK-LABEL: udiv8:
+; CHECK-NOT: call
+; CHECK:     mov.b {{r[0-9]+}}, 0(r14)
+  %r = udiv i8 %a, 10
+  store i8 %r, i8* %p
+  ret void
+}
+
+define i16 @udiv10(i16 %a) nounwind {
+; CHECK-LABEL: udiv10:
+; CHECK: call #__udivhi3
+  %r = udiv i16 %a, 10
+  ret i16 %r
+}
@@ -0,0 +1,106 @@
+; RUN: llc < %s -mtriple=tnt -enable-machine-outliner -verify-machineinstrs \
+; RUN:   | FileCheck %s
+; RUN: llc < %s -mtriple=tnt | FileCheck -check-prefix=NOOUTLINE %s
+
+; Sequences repeated across functions are moved into a function of their
+; own. One that ends in a return is jumped to and returns to the original
+; caller; any other is called, and so must not touch the stack.
+
+@a = global i16 0
+@b = global i16 0
+@c = global i16 0
+
+; CHECK-LABEL: f1:
+; CHECK-NEXT: BB#0:
+; CHECK-NEXT: call #OUTLINED_FUNCTION_0
+; CHECK-NEXT: ret
+; NOOUTLINE-LABEL: f1:
+; NOOUTLINE-NOT: OUTLINED_FUNCTION
+define void @f1(i16 %x) nounwind {
+  %v = load volatile i16, i16* @a
+  %s = add i16 %v, %x
+  store volatile i16 %s, i16* @b
+  %w = load volatile i16, i16* @c
+  %t = xor i16 %w, 21845
+  store volatile i16 %t, i16* @a
+  ret void
+}
+
+; CHECK-LABEL: f2:
+; CHECK-NEXT: BB#0:
+; CHECK-NEXT: call #OUTLINED_FUNCTION_0
+; CHECK-NEXT: mov.w #0, &c
+; CHECK-NEXT: ret
+define void @f2(i16 %x) nounwind {
+  %v = load volatile i16, i16* @a
+  %s = add i16 %v, %x
+  store volatile i16 %s, i16* @b
+  %w = load volatile i16, i16* @c
+  %t = xor i16 %w, 21845
+  store volatile i16 %t, i16* @a
+  store volatile i16 0, i16* @c
+  ret void
+}
+
+; CHECK-LABEL: f3:
+; CHECK-NEXT: BB#0:
+; CHECK-NEXT: call #OUTLINED_FUNCTION_0
+; CHECK-NEXT: ret
+define void @f3(i16 %x) nounwind {
+  %v = load volatile i16, i16* @a
+  %s = add i16 %v, %x
+  store volatile i16 %s, i16* @b
+  %w = load volatile i16, i16* @c
+  %t = xor i16 %w, 21845
+  store volatile i16 %t, i16* @a
+  ret void
+}
+
+declare void @g(i16)
+
+; The epilogue pops callee-saved registers, so it can only be reached by a
+; jump.
+; CHECK-LABEL: t1:
+; CHECK:      push.w r11
+; CHECK:      call #g
+; CHECK-NEXT: mov.w r11, r15
+; CHECK-NEXT: br #OUTLINED_FUNCTION_1
+define i16 @t1(i16 %a, i16 %b) nounwind {
+  call void @g(i16 %a)
+  call void @g(i16 %b)
+  %s = add i16 %a, %b
+  %r = xor i16 %s, 4660
+  ret i16 %r
+}
+
+; CHECK-LABEL: t2:
+; CHECK:      push.w r11
+; CHECK:      call #g
+; CHECK-NEXT: mov.w r10, r15
+; CHECK-NEXT: br #OUTLINED_FUNCTION_1
+define i16 @t2(i16 %a, i16 %b) nounwind {
+  call void @g(i16 %b)
+  call void @g(i16 %a)
+  %s = add i16 %a, %b
+  %r = xor i16 %s, 4660
+  ret i16 %r
+}
+
+; CHECK-LABEL: OUTLINED_FUNCTION_0:
+; CHECK-NEXT: BB#0:
+; CHECK-NEXT: add.w &a, r15
+; CHECK-NEXT: mov.w r15, &b
+; CHECK-NEXT: mov.w #21845, r12
+; CHECK-NEXT: xor.w &c, r12
+; CHECK-NEXT: mov.w r12, &a
+; CHECK-NEXT: ret
+
+; CHECK-LABEL: OUTLINED_FUNCTION_1:
+; CHECK-NEXT: BB#0:
+; CHECK-NEXT: call #g
+; CHECK-NEXT: add.w r11, r10
+; CHECK-NEXT: xor.w #4660, r10
+; CHECK-NEXT: mov.w r10, r15
+; CHECK-NEXT: pop.w r10
+; CHECK-NEXT: pop.w r11
+; CHECK-NEXT: ret
@@ -0,0 +1,75 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+
+; Array walks use pointer induction variables and @Rn+ operands, and the
+; loop counter sets the flags for the exit branch.
+
+; CHECK-LABEL: copy16:
+; CHECK:      .LBB0_[[LOOP:[0-9]+]]:
+; CHECK-NOT:  {{^.LBB}}
+; CHECK:      mov.w @r14+, 0(r15)
+; CHECK-NEXT: add.w #2, r15
+; CHECK-NEXT: add.w #-1, r13
+; CHECK-NEXT: jne .LBB0_[[LOOP]]
+define void @copy16(i16* %d, i16* %s, i16 %n) nounwind {
+entry:
+  %c0 = icmp eq i16 %n, 0
+  br i1 %c0, label %exit, label %loop
+loop:
+  %i = phi i16 [0, %entry], [%i1, %loop]
+  %ps = getelementptr i16, i16* %s, i16 %i
+  %pd = getelementptr i16, i16* %d, i16 %i
+  %v = load i16, i16* %ps
+  store i16 %v, i16* %pd
+  %i1 = add i16 %i, 1
+  %c = icmp eq i16 %i1, %n
+  br i1 %c, label %exit, label %loop
+exit:
+  ret void
+}
+
+; CHECK-LABEL: copy8:
+; CHECK:      mov.b @r14+, 0(r15)
+; CHECK-NEXT: add.w #1, r15
+; CHECK-NEXT: add.w #-1, r13
+; CHECK-NEXT: jne
+define void @copy8(i8* %d, i8* %s, i16 %n) nounwind {
+entry:
+  br label %loop
+loop:
+  %i = phi i16 [0, %entry], [%i1, %loop]
+  %ps = getelementptr i8, i8* %s, i16 %i
+  %pd = getelementptr i8, i8* %d, i16 %i
+  %v = load i8, i8* %ps
+  store i8 %v, i8* %pd
+  %i1 = add i16 %i, 1
+  %c = icmp eq i16 %i1, %n
+  br i1 %c, label %exit, label %loop
+exit:
+  ret void
+}
+
+; CHECK-LABEL: vadd:
+; CHECK:      mov.w @r13+, [[R:r[0-9]+]]
+; CHECK-NEXT: add.w @r14+, [[R]]
+; CHECK-NEXT: mov.w [[R]], 0(r15)
+; CHECK-NEXT: add.w #2, r15
+; CHECK-NEXT: add.w #-1, r12
+; CHECK-NEXT: jne
+define void @vadd(i16* %d, i16* %a, i16* %b, i16 %n) nounwind {
+entry:
+  br label %loop
+loop:
+  %i = phi i16 [0, %entry], [%i1, %loop]
+  %pa = getelementptr i16, i16* %a, i16 %i
+  %pb = getelementptr i16, i16* %b, i16 %i
+  %pd = getelementptr i16, i16* %d, i16 %i
+  %va = load i16, i16* %pa
+  %vb = load i16, i16* %pb
+  %s = add i16 %va, %vb
+  store i16 %s, i16* %pd
+  %i1 = add i16 %i, 1
+  %c = icmp eq i16 %i1, %n
+  br i1 %c, label %exit, label %loop
+exit:
+  ret void
+}
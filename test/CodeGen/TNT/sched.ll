@@ -0,0 +1,17 @@
+; RUN: llc < %s -mtriple=tnt -debug-only=misched 2>&1 | FileCheck %s
+; REQUIRES: asserts
+
+; The scheduling model gives each addressing mode its cycle count.
+
+; CHECK: ADD16rm
+; CHECK: Latency            : 3
+; CHECK: ADD16mr
+; CHECK: Latency            : 4
+define void @f(i16* %p, i16* %q, i16 %a) nounwind {
+  %v = load i16, i16* %p
+  %s = add i16 %v, %a
+  %w = load i16, i16* %q
+  %t = add i16 %w, %s
+  store i16 %t, i16* %q
+  ret void
+}
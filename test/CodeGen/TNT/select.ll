@@ -0,0 +1,16 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+
+; The branch a select expands into reads the flags of the compare, so the
+; scheduler must not move flag-setting arithmetic in between.
+
+define i16 @step(i16 %c) nounwind {
+; CHECK-LABEL: step:
+; CHECK:      bit.w #-32768, r{{[0-9]+}}
+; CHECK-NEXT: j{{eq|ne}}
+  %top = and i16 %c, -32768
+  %c2 = shl i16 %c, 1
+  %c3 = xor i16 %c2, 4129
+  %t = icmp eq i16 %top, 0
+  %r = select i1 %t, i16 %c2, i16 %c3
+  ret i16 %r
+}
@@ -0,0 +1,115 @@
+; RUN: llc < %s -mtriple=tnt | FileCheck %s
+
+; Shifts by 8 or more move whole bytes with swpb instead of 8+ single-bit
+; steps.
+
+; CHECK-LABEL: shl9:
+; CHECK:      mov.b r15, r15
+; CHECK-NEXT: swpb r15
+; CHECK-NEXT: rla.w r15
+; CHECK-NEXT: ret
+define i16 @shl9(i16 %a) nounwind {
+  %r = shl i16 %a, 9
+  ret i16 %r
+}
+
+; CHECK-LABEL: lshr12:
+; CHECK:      swpb r15
+; CHECK-NEXT: mov.b r15, r15
+; CHECK-NEXT: rra.w r15
+; CHECK-NEXT: rra.w r15
+; CHECK-NEXT: rra.w r15
+; CHECK-NEXT: rra.w r15
+; CHECK-NEXT: ret
+define i16 @lshr12(i16 %a) nounwind {
+  %r = lshr i16 %a, 12
+  ret i16 %r
+}
+
+; CHECK-LABEL: ashr8:
+; CHECK:      swpb r15
+; CHECK-NEXT: sxt r15
+; CHECK-NEXT: ret
+define i16 @ashr8(i16 %a) nounwind {
+  %r = ashr i16 %a, 8
+  ret i16 %r
+}
+
+; Below 8 the single-bit sequence is kept.
+; CHECK-LABEL: lshr3:
+; CHECK:      clrc
+; CHECK-NEXT: rrc.w r15
+; CHECK-NEXT: rra.w r15
+; CHECK-NEXT: rra.w r15
+; CHECK-NEXT: ret
+define i16 @lshr3(i16 %a) nounwind {
+  %r = lshr i16 %a, 3
+  ret i16 %r
+}
+
+; Variable shifts test each bit of the amount and shift by 8, 4, 2 and 1
+; in straight-line code: at most 15 shift instructions, no loop.
+
+; CHECK-LABEL: shlv:
+; CHECK:      bit.b #8, r14
+; CHECK-NEXT: jeq
+; CHECK:      mov.b r15, r15
+; CHECK-NEXT: swpb r15
+; CHECK:      bit.b #4, r14
+; CHECK-NEXT: jeq
+; CHECK:      bit.b #2, r14
+; CHECK:      bit.b #1, r14
+; CHECK-NEXT: jeq
+; CHECK:      rla.w r15
+; CHECK-NOT:  jne
+; CHECK:      ret
+define i16 @shlv(i16 %a, i16 %n) nounwind {
+  %r = shl i16 %a, %n
+  ret i16 %r
+}
+
+; CHECK-LABEL: lshrv:
+; CHECK:      bit.b #8, r14
+; CHECK-NEXT: jeq
+; CHECK:      swpb r15
+; CHECK-NEXT: mov.b r15, r15
+; CHECK:      bit.b #4, r14
+; CHECK-NEXT: jeq
+; CHECK:      clrc
+; CHECK-NEXT: rrc.w r15
+; CHECK-NEXT: rra.w r15
+; CHECK-NEXT: rra.w r15
+; CHECK-NEXT: rra.w r15
+; CHECK:      bit.b #1, r14
+; CHECK-NOT:  jne
+; CHECK:      ret
+define i16 @lshrv(i16 %a, i16 %n) nounwind {
+  %r = lshr i16 %a, %n
+  ret i16 %r
+}
+
+; CHECK-LABEL: ashrv:
+; CHECK:      bit.b #8, r14
+; CHECK:      swpb r15
+; CHECK-NEXT: sxt r15
+; CHECK-NOT:  jne
+; CHECK:      ret
+define i16 @ashrv(i16 %a, i16 %n) nounwind {
+  %r = ashr i16 %a, %n
+  ret i16 %r
+}
+
+; Bytes only need the 4, 2 and 1 steps.
+; CHECK-LABEL: shlv8:
+; CHECK-NOT:  bit.b #8
+; CHECK:      bit.b #4, r14
+; CHECK:      bit.b #2, r14
+; CHECK:      bit.b #1, r14
+; CHECK-NOT:  jne
+; CHECK:      ret
+define void @shlv8(i8* %p, i8 %n) nounwind {
+  %a = load i8, i8* %p
+  %r = shl i8 %a, %n
+  store i8 %r, i8* %p
+  ret void
+}
@@ -0,0 +1,69 @@
+; RUN: llc < %s -mtriple=tnt -verify-machineinstrs | FileCheck %s
+; RUN: llc < %s -mtriple=tnt -enable-shrink-wrap=false \
+; RUN:   | FileCheck -check-prefix=NOSW %s
+
+; The callee-saved registers and the frame are only set up on the path that
+; needs them; the early return does without.
+
+declare i16 @work(i16)
+
+; CHECK-LABEL: early:
+; CHECK:      cmp.w #0, r15
+; CHECK-NEXT: jeq [[FAST:.LBB[0-9_]+]]
+; CHECK:      push.w r11
+; CHECK:      call #work
+; CHECK:      call #work
+; CHECK:      pop.w r11
+; CHECK-NEXT: ret
+; CHECK:      [[FAST]]:
+; CHECK-NEXT: mov.w #0, r15
+; CHECK-NEXT: ret
+
+; NOSW-LABEL: early:
+; NOSW:       push.w r11
+; NOSW-NEXT:  cmp.w #0, r15
+define i16 @early(i16 %n) nounwind {
+entry:
+  %c = icmp eq i16 %n, 0
+  br i1 %c, label %fast, label %slow
+
+fast:
+  ret i16 0
+
+slow:
+  %x = call i16 @work(i16 %n)
+  %y = call i16 @work(i16 %x)
+  %z = add i16 %x, %y
+  ret i16 %z
+}
+
+; CHECK-LABEL: withfp:
+; CHECK:      cmp.w #4, r15
+; CHECK-NEXT: jge [[FAST:.LBB[0-9_]+]]
+; CHECK:      push.w r4
+; CHECK-NEXT: mov.w r1, r4
+; CHECK-NEXT: push.w r11
+; CHECK-NEXT: sub.w #2, r1
+; CHECK:      add.w #2, r1
+; CHECK-NEXT: pop.w r11
+; CHECK-NEXT: pop.w r4
+; CHECK-NEXT: ret
+; CHECK:      [[FAST]]:
+; CHECK-NEXT: ret
+define i16 @withfp(i16 %n) nounwind "no-frame-pointer-elim"="true" {
+entry:
+  %buf = alloca i16
+  %c = icmp slt i16 %n, 4
+  br i1 %c, label %slow, label %fast
+
+fast:
+  ret i16 %n
+
+slow:
+  store volatile i16 %n, i16* %buf
+  %v = load volatile i16, i16* %buf
+  %x = call i16 @work(i16 %v)
+  %y = call i16 @work(i16 %x)
+  %z = add i16 %x, %y
+  ret i16 %z
+}
@@ -0,0 +1,83 @@
+; RUN: llc < %s -mtriple=tnt -verify-machineinstrs | FileCheck %s
+
+; Eleven values are live across the call but only eight callee-saved
+; registers exist. The remaining ones are spilled straight from memory and
+; reloaded as the source operand of the instruction that uses them.
+
+@g = global [11 x i16] zeroinitializer
+@out = global [11 x i16] zeroinitializer
+
+declare i16 @ext()
+
+; CHECK-LABEL: f:
+; CHECK:       mov.w &g+16, 0(r1) ; 2-byte Folded Spill
+; CHECK-NEXT:  mov.w &g+18, 2(r1) ; 2-byte Folded Spill
+; CHECK-NEXT:  mov.w &g+20, 4(r1) ; 2-byte Folded Spill
+; CHECK-NEXT:  call #ext
+; CHECK-NOT:   Reload
+; CHECK:       sub.w 0(r1), r12 ; 2-byte Folded Reload
+; CHECK-NEXT:  mov.w r12, &out+16
+; CHECK:       sub.w 2(r1), r12 ; 2-byte Folded Reload
+; CHECK-NEXT:  mov.w r12, &out+18
+; CHECK:       sub.w 4(r1), r15 ; 2-byte Folded Reload
+; CHECK-NEXT:  mov.w r15, &out+20
+
+define void @f() {
+  %p0 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 0
+  %v0 = load volatile i16, i16* %p0
+  %p1 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 1
+  %v1 = load volatile i16, i16* %p1
+  %p2 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 2
+  %v2 = load volatile i16, i16* %p2
+  %p3 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 3
+  %v3 = load volatile i16, i16* %p3
+  %p4 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 4
+  %v4 = load volatile i16, i16* %p4
+  %p5 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 5
+  %v5 = load volatile i16, i16* %p5
+  %p6 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 6
+  %v6 = load volatile i16, i16* %p6
+  %p7 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 7
+  %v7 = load volatile i16, i16* %p7
+  %p8 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 8
+  %v8 = load volatile i16, i16* %p8
+  %p9 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 9
+  %v9 = load volatile i16, i16* %p9
+  %p10 = getelementptr [11 x i16], [11 x i16]* @g, i16 0, i16 10
+  %v10 = load volatile i16, i16* %p10
+  %r = call i16 @ext()
+  %q0 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 0
+  %t0 = sub i16 %r, %v0
+  store volatile i16 %t0, i16* %q0
+  %q1 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 1
+  %t1 = sub i16 %r, %v1
+  store volatile i16 %t1, i16* %q1
+  %q2 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 2
+  %t2 = sub i16 %r, %v2
+  store volatile i16 %t2, i16* %q2
+  %q3 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 3
+  %t3 = sub i16 %r, %v3
+  store volatile i16 %t3, i16* %q3
+  %q4 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 4
+  %t4 = sub i16 %r, %v4
+  store volatile i16 %t4, i16* %q4
+  %q5 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 5
+  %t5 = sub i16 %r, %v5
+  store volatile i16 %t5, i16* %q5
+  %q6 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 6
+  %t6 = sub i16 %r, %v6
+  store volatile i16 %t6, i16* %q6
+  %q7 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 7
+  %t7 = sub i16 %r, %v7
+  store volatile i16 %t7, i16* %q7
+  %q8 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 8
+  %t8 = sub i16 %r, %v8
+  store volatile i16 %t8, i16* %q8
+  %q9 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 9
+  %t9 = sub i16 %r, %v9
+  store volatile i16 %t9, i16* %q9
+  %q10 = getelementptr [11 x i16], [11 x i16]* @out, i16 0, i16 10
+  %t10 = sub i16 %r, %v10
+  store volatile i16 %t10, i16* %q10
+  ret void
+}
@@ -0,0 +1,87 @@
+; RUN: llvm-mc -triple=tnt -show-encoding %s | FileCheck %s
+; RUN: llvm-mc -triple=tnt -filetype=obj %s -o - \
+; RUN:   | llvm-objdump -d -triple=tnt - | FileCheck -check-prefix=OBJ %s
+
+foo:
+  mov r12, r13
+  mov.b r12, r13
+  mov #42, r12
+  mov #8, 4(r12)
+  mov &0x200, r12
+  mov r12, &0x200
+  mov @r12, r13
+  mov @r12+, r13
+  add.b @r12+, r13
+  add 2(r12), r13
+  mov @r12+, 2(r13)
+  mov #foo, r12
+
+; CHECK: mov.w r12, r13     ; encoding: [0x0d,0x4c]
+; CHECK: mov.b r12, r13     ; encoding: [0x4d,0x4c]
+; CHECK: mov.w #42, r12     ; encoding: [0x3c,0x40,0x2a,0x00]
+; CHECK: mov.w #8, 4(r12)   ; encoding: [0xbc,0x42,0x04,0x00]
+; CHECK: mov.w &512, r12    ; encoding: [0x1c,0x42,0x00,0x02]
+; CHECK: mov.w r12, &512    ; encoding: [0x82,0x4c,0x00,0x02]
+; CHECK: mov.w 0(r12), r13  ; encoding: [0x1d,0x4c,0x00,0x00]
+; CHECK: mov.w @r12+, r13   ; encoding: [0x3d,0x4c]
+; CHECK: add.b @r12+, r13   ; encoding: [0x7d,0x5c]
+; CHECK: add.w 2(r12), r13  ; encoding: [0x1d,0x5c,0x02,0x00]
+; CHECK: mov.w @r12+, 2(r13) ; encoding: [0xbd,0x4c,0x02,0x00]
+; CHECK: mov.w #foo, r12    ; encoding: [0x3c,0x40,A,A]
+; CHECK-NEXT:               ;   fixup A - offset: 2, value: foo, kind: fixup_16_byte
+
+; Constant generator operands take no extension word.
+  mov #0, r12
+  mov #-1, r12
+  cmp #1, r12
+  bit #4, r12
+  subc #2, r13
+  clrc
+
+; CHECK: mov.w #0, r12      ; encoding: [0x0c,0x43]
+; CHECK: mov.w #-1, r12     ; encoding: [0x3c,0x43]
+; CHECK: cmp.w #1, r12      ; encoding: [0x1c,0x93]
+; CHECK: bit.w #4, r12      ; encoding: [0x2c,0xb2]
+; CHECK: subc.w #2, r13     ; encoding: [0x2d,0x73]
+; CHECK: bic.w #1, r2       ; encoding: [0x12,0xc3]
+
+  rla r12
+  rrc r12
+  rra.b r12
+  sxt r12
+  swpb r12
+  push r12
+  pop r12
+  call r12
+  ret
+  reti
+  nop
+
+; CHECK: add.w r12, r12     ; encoding: [0x0c,0x5c]
+; CHECK: rrc.w r12          ; encoding: [0x0c,0x10]
+; CHECK: rra.b r12          ; encoding: [0x4c,0x11]
+; CHECK: sxt r12            ; encoding: [0x8c,0x11]
+; CHECK: swpb r12           ; encoding: [0x8c,0x10]
+; CHECK: push.w r12         ; encoding: [0x0c,0x12]
+; CHECK: pop.w r12          ; encoding: [0x3c,0x41]
+; CHECK: call r12           ; encoding: [0x8c,0x12]
+; CHECK: ret                ; encoding: [0x30,0x41]
+; CHECK: reti               ; encoding: [0x00,0x13]
+; CHECK: nop                ; encoding: [0x03,0x43]
+
+  jne foo
+  jz foo
+  jn foo
+  jmp foo
+  jmp $+4
+
+; CHECK: jne foo            ; encoding: [A,0b001000AA]
+; CHECK: jeq foo            ; encoding: [A,0b001001AA]
+; CHECK: jn foo             ; encoding: [A,0b001100AA]
+; CHECK: jmp foo            ; encoding: [A,0b001111AA]
+
+; OBJ:      4a: da 23    jne $-74
+; OBJ-NEXT: 4c: d9 27    jeq $-76
+; OBJ-NEXT: 4e: d8 33    jn $-78
+; OBJ-NEXT: 50: d7 3f    jmp $-80
+; OBJ-NEXT: 52: 01 3c    jmp $+4
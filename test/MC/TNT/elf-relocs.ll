@@ -0,0 +1,44 @@
+; RUN: llc -mtriple=tnt -filetype=obj < %s -o %t
+; RUN: llvm-readobj -h -r %t | FileCheck %s
+; RUN: llvm-objdump -s -j .text %t | FileCheck --check-prefix=TEXT %s
+
+target datalayout = "e-m:e-p:16:16-i32:16:32-a:16-n8:16"
+
+; CHECK: Format: ELF32-msp430
+; CHECK: Machine: EM_MSP430 (0x69)
+
+; CHECK:      Relocations [
+; CHECK-NEXT:   Section (3) .rela.text {
+; CHECK-NEXT:     0x4 R_MSP430_16_BYTE foo 0x0
+; CHECK-NEXT:     0x6 R_MSP430_16_BYTE bar 0x0
+; CHECK-NEXT:     0xC R_MSP430_16_BYTE ext 0x0
+; CHECK-NEXT:   }
+; CHECK-NEXT:   Section (5) .rela.data {
+; CHECK-NEXT:     0x0 R_MSP430_16 foo 0x0
+; CHECK-NEXT:   }
+; CHECK-NEXT: ]
+
+; The local branch is resolved at assembly time: "jeq $+8" (0x2403) skips the
+; three instructions of the fall-through block.
+; TEXT:      Contents of section .text:
+; TEXT-NEXT: 0000 0b129242 00000000 0b4fb012 00003b90
+; TEXT-NEXT: 0010 00000324 0f4b3b41 30413f40 01003b41
+; TEXT-NEXT: 0020 3041
+
+@foo = common global i16 0, align 2
+@bar = common global i16 0, align 2
+@ptr = global i16* @foo, align 2
+
+declare void @ext()
+
+define i16 @f(i16 %a) {
+  %v = load i16, i16* @foo
+  store i16 %v, i16* @bar
+  call void @ext()
+  %c = icmp eq i16 %a, 0
+  br i1 %c, label %t, label %e
+t:
+  ret i16 1
+e:
+  ret i16 %a
+}
@@ -0,0 +1,92 @@
+; RUN: llc -mtriple=tnt -show-mc-encoding < %s | FileCheck %s
+
+target datalayout = "e-m:e-p:16:16-i32:16:32-a:16-n8:16"
+
+@foo = common global i16 0, align 2
+@bar = common global i16 0, align 2
+
+define i16 @rr(i16 %a, i16 %b) {
+; CHECK-LABEL: rr:
+; CHECK: add.w r14, r15 ; encoding: [0x0f,0x5e]
+; CHECK: ret ; encoding: [0x30,0x41]
+  %r = add i16 %a, %b
+  ret i16 %r
+}
+
+define i16 @ri(i16 %a) {
+; CHECK-LABEL: ri:
+; CHECK: add.w #300, r15 ; encoding: [0x3f,0x50,0x2c,0x01]
+  %r = add i16 %a, 300
+  ret i16 %r
+}
+
+define i16 @rm(i16* %p) {
+; CHECK-LABEL: rm:
+; CHECK: mov.w 6(r15), r15 ; encoding: [0x1f,0x4f,0x06,0x00]
+  %q = getelementptr i16, i16* %p, i16 3
+  %v = load i16, i16* %q
+  ret i16 %v
+}
+
+define void @mm() {
+; CHECK-LABEL: mm:
+; CHECK: mov.w &foo, &bar ; encoding: [0x92,0x42,A,A,B,B]
+; CHECK-NEXT: fixup A - offset: 2, value: foo, kind: fixup_16_byte
+; CHECK-NEXT: fixup B - offset: 4, value: bar, kind: fixup_16_byte
+  %a = load i16, i16* @foo
+  store i16 %a, i16* @bar
+  ret void
+}
+
+define void @mi() {
+; CHECK-LABEL: mi:
+; CHECK: mov.w #42, &foo ; encoding: [0xb2,0x40,0x2a,0x00,A,A]
+; CHECK-NEXT: fixup A - offset: 4, value: foo, kind: fixup_16_byte
+  store i16 42, i16* @foo
+  ret void
+}
+
+define i16 @shifts(i16 %a) {
+; CHECK-LABEL: shifts:
+; CHECK: rra.w r15 ; encoding: [0x0f,0x11]
+; CHECK: clrc
+; CHECK-NEXT: rrc.w r15 ; encoding: [0x12,0xc3,0x0f,0x10]
+  %b = ashr i16 %a, 1
+  %c = lshr i16 %b, 1
+  ret i16 %c
+}
+
+define i16 @sext(i16 %a) {
+; CHECK-LABEL: sext:
+; CHECK: sxt r15 ; encoding: [0x8f,0x11]
+  %t = trunc i16 %a to i8
+  %r = sext i8 %t to i16
+  ret i16 %r
+}
+
+declare void @ext()
+
+define void @calls(void ()* %f) {
+; CHECK-LABEL: calls:
+; CHECK: push.w r11 ; encoding: [0x0b,0x12]
+; CHECK: call #ext ; encoding: [0xb0,0x12,A,A]
+; CHECK-NEXT: fixup A - offset: 2, value: ext, kind: fixup_16_byte
+; CHECK: call r11 ; encoding: [0x8b,0x12]
+; CHECK: pop.w r11 ; encoding: [0x3b,0x41]
+  call void @ext()
+  call void %f()
+  ret void
+}
+
+define i16 @branch(i16 %a, i16 %b) {
+; CHECK-LABEL: branch:
+; CHECK: cmp.w r14, r15 ; encoding: [0x0f,0x9e]
+; CHECK: jne .LBB{{[0-9]+}}_2 ; encoding: [A,0b001000AA]
+; CHECK-NEXT: fixup A - offset: 0, value: .LBB{{[0-9]+}}_2, kind: fixup_10_pcrel
+  %c = icmp eq i16 %a, %b
+  br i1 %c, label %t, label %f
+t:
+  ret i16 1
+f:
+  ret i16 2
+}
@@ -0,0 +1,10 @@
+; RUN: not llvm-mc -triple=tnt %s 2>&1 | FileCheck %s
+
+; CHECK: error: expected '#', '&' or indexed operand
+  mov foo, r12
+; CHECK: error: expected register
+  mov @foo, r12
+; CHECK: error: too few operands for instruction
+  mov r12
+; CHECK: error: invalid instruction mnemonic
+  frob r12
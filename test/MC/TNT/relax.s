@@ -0,0 +1,49 @@
+; RUN: llvm-mc -triple=tnt -filetype=obj %s -o - \
+; RUN:   | llvm-objdump -d -r -triple=tnt - | FileCheck %s
+; RUN: not llvm-mc -triple=tnt -filetype=obj %s -o /dev/null --defsym ERR=1 \
+; RUN:   2>&1 | FileCheck -check-prefix=ERR %s
+
+; Jumps out of the 10 bit range are relaxed to a branch through @pc+, with
+; conditional ones jumping over it on the inverted condition.
+
+foo:
+  jne far
+  jeq near
+  jmp far
+  jl far
+  jn near
+near:
+  .space 1100
+far:
+  jhs foo
+  jmp ext
+  jmp far
+  jn ext
+
+; CHECK:      0: 02 24    jeq $+6
+; CHECK-NEXT: 2: 30 40 00 00 br #0
+; CHECK-NEXT:    00000004: R_MSP430_16_BYTE .text+1120
+; CHECK-NEXT: 6: 06 24    jeq $+14
+; CHECK-NEXT: 8: 30 40 00 00 br #0
+; CHECK-NEXT:    0000000a: R_MSP430_16_BYTE .text+1120
+; CHECK-NEXT: c: 02 34    jge $+6
+; CHECK-NEXT: e: 30 40 00 00 br #0
+; CHECK-NEXT:    00000010: R_MSP430_16_BYTE .text+1120
+; CHECK-NEXT: 12: 00 30   jn $+2
+
+; CHECK:      460: 02 28  jlo $+6
+; CHECK-NEXT: 462: 30 40 00 00 br #0
+; CHECK-NEXT:      00000464: R_MSP430_16_BYTE .text
+; CHECK-NEXT: 466: 30 40 00 00 br #0
+; CHECK-NEXT:      00000468: R_MSP430_16_BYTE ext
+; CHECK-NEXT: 46a: fa 3f  jmp $-10
+
+; A jump left for the linker keeps an empty offset field.
+; CHECK-NEXT: 46c: 00 30  jn $+2
+; CHECK-NEXT:      0000046c: R_MSP430_10_PCREL ext
+
+; jn has no inverse and is never relaxed.
+.ifdef ERR
+; ERR: error: fixup value out of range
+  jn foo
+.endif
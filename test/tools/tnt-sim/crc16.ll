@@ -0,0 +1,64 @@
+; CRC-16/CCITT over a byte buffer: byte loads, shifts and data-dependent
+; branches in a tight inner loop.
+; RUN: llc -mtriple=tnt -filetype=obj %s -o %t.o
+; RUN: tnt-sim -max-cycles=1200 %t.o | FileCheck %s
+; RUN: not tnt-sim -max-cycles=100 -no-profile %t.o 2>&1 \
+; RUN:   | FileCheck -check-prefix=LIMIT %s
+
+target datalayout = "e-m:e-p:16:16-i32:16:32-a:16-n8:16"
+target triple = "tnt"
+
+@data = global [9 x i8] c"123456789", align 1
+
+define i16 @crc16(i8* %p, i16 %n) {
+entry:
+  %z = icmp eq i16 %n, 0
+  br i1 %z, label %exit, label %loop
+
+loop:
+  %i = phi i16 [ 0, %entry ], [ %i.next, %bits.done ]
+  %crc = phi i16 [ -1, %entry ], [ %crc.out, %bits.done ]
+  %ptr = getelementptr i8, i8* %p, i16 %i
+  %b = load i8, i8* %ptr
+  %bw = zext i8 %b to i16
+  %sh = shl i16 %bw, 8
+  %x = xor i16 %crc, %sh
+  br label %bits
+
+bits:
+  %k = phi i16 [ 0, %loop ], [ %k.next, %bits ]
+  %c = phi i16 [ %x, %loop ], [ %c.next, %bits ]
+  %top = and i16 %c, -32768
+  %c2 = shl i16 %c, 1
+  %c3 = xor i16 %c2, 4129
+  %t = icmp eq i16 %top, 0
+  %c.next = select i1 %t, i16 %c2, i16 %c3
+  %k.next = add i16 %k, 1
+  %kd = icmp eq i16 %k.next, 8
+  br i1 %kd, label %bits.done, label %bits
+
+bits.done:
+  %crc.out = phi i16 [ %c.next, %bits ]
+  %i.next = add i16 %i, 1
+  %d = icmp eq i16 %i.next, %n
+  br i1 %d, label %exit, label %loop
+
+exit:
+  %r = phi i16 [ -1, %entry ], [ %crc.out, %bits.done ]
+  ret i16 %r
+}
+
+define i16 @main() {
+  %r = call i16 @crc16(i8* getelementptr ([9 x i8], [9 x i8]* @data, i16 0, i16 0), i16 9)
+  ret i16 %r
+}
+
+; CHECK: result: r15 = 10673 (0x29b1)
+; CHECK: instructions:
+; CHECK: cycles:
+; CHECK: calls: 1 (0 runtime)
+; CHECK: profile:
+; CHECK: crc16
+; CHECK: main
+
+; LIMIT: error: cycle limit of 100 exceeded
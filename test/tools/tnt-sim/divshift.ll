@@ -0,0 +1,43 @@
+; 32-bit division and variable shifts go through runtime routines.
+; RUN: llc -mtriple=tnt -filetype=obj %s -o %t.o
+; RUN: tnt-sim -max-cycles=20000 -arg=7 %t.o | FileCheck %s
+
+target datalayout = "e-m:e-p:16:16-i32:16:32-a:16-n8:16"
+target triple = "tnt"
+
+; Sum of (x / d) % 1000 + (x >> (d & 7)) for d = 1 .. 10, in 32 bits.
+define i32 @mix(i32 %x, i16 %s) {
+entry:
+  br label %loop
+
+loop:
+  %d = phi i32 [ 1, %entry ], [ %d.next, %loop ]
+  %acc = phi i32 [ 0, %entry ], [ %acc.next, %loop ]
+  %q = udiv i32 %x, %d
+  %r = urem i32 %q, 1000
+  %amt = and i32 %d, 7
+  %sh = lshr i32 %x, %amt
+  %t = add i32 %r, %sh
+  %acc.next = add i32 %acc, %t
+  %d.next = add i32 %d, 1
+  %done = icmp eq i32 %d.next, 11
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %sw = zext i16 %s to i32
+  %res = shl i32 %acc.next, %sw
+  ret i32 %res
+}
+
+define i16 @main(i16 %s) {
+  %v = call i32 @mix(i32 123456789, i16 %s)
+  %lo = trunc i32 %v to i16
+  %hi.w = lshr i32 %v, 16
+  %hi = trunc i32 %hi.w to i16
+  %r = xor i16 %lo, %hi
+  ret i16 %r
+}
+
+; CHECK: result: r15 = 4838 (0x12e6)
+; CHECK: __udivsi3
+; CHECK: __umodsi3
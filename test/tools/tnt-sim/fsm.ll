@@ -0,0 +1,75 @@
+; A table-driven state machine: a dense switch becomes a jump table whose
+; entries are relocated into read-only data.
+; RUN: llc -mtriple=tnt -filetype=obj %s -o %t.o
+; RUN: tnt-sim -max-cycles=2000 %t.o | FileCheck %s
+
+target datalayout = "e-m:e-p:16:16-i32:16:32-a:16-n8:16"
+target triple = "tnt"
+
+@input = global [24 x i8] c"ab1c2;dd3;;x9;aa;1;b2;c3", align 1
+
+; Count identifiers followed by a digit and terminated by ';'.
+define i16 @scan(i8* %p, i16 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i16 [ 0, %entry ], [ %i.next, %next ]
+  %state = phi i16 [ 0, %entry ], [ %state.next, %next ]
+  %count = phi i16 [ 0, %entry ], [ %count.next, %next ]
+  %ptr = getelementptr i8, i8* %p, i16 %i
+  %ch = load i8, i8* %ptr
+  %isdigit.lo = icmp uge i8 %ch, 48
+  %isdigit.hi = icmp ule i8 %ch, 57
+  %isdigit = and i1 %isdigit.lo, %isdigit.hi
+  %isend = icmp eq i8 %ch, 59
+  switch i16 %state, label %s.other [
+    i16 0, label %s.start
+    i16 1, label %s.ident
+    i16 2, label %s.digit
+    i16 3, label %s.skip
+  ]
+
+s.start:
+  %st0 = select i1 %isend, i16 0, i16 1
+  %st0.d = select i1 %isdigit, i16 3, i16 %st0
+  br label %next
+
+s.ident:
+  %st1 = select i1 %isdigit, i16 2, i16 1
+  %st1.e = select i1 %isend, i16 0, i16 %st1
+  br label %next
+
+s.digit:
+  %inc = zext i1 %isend to i16
+  %st2 = select i1 %isend, i16 0, i16 3
+  br label %next
+
+s.skip:
+  %st3 = select i1 %isend, i16 0, i16 3
+  br label %next
+
+s.other:
+  br label %next
+
+next:
+  %state.next = phi i16 [ %st0.d, %s.start ], [ %st1.e, %s.ident ],
+                        [ %st2, %s.digit ], [ %st3, %s.skip ], [ 0, %s.other ]
+  %add = phi i16 [ 0, %s.start ], [ 0, %s.ident ], [ %inc, %s.digit ],
+                 [ 0, %s.skip ], [ 0, %s.other ]
+  %count.next = add i16 %count, %add
+  %i.next = add i16 %i, 1
+  %d = icmp eq i16 %i.next, %n
+  br i1 %d, label %exit, label %loop
+
+exit:
+  ret i16 %count.next
+}
+
+define i16 @main() {
+  %r = call i16 @scan(i8* getelementptr ([24 x i8], [24 x i8]* @input, i16 0, i16 0), i16 24)
+  ret i16 %r
+}
+
+; CHECK: result: r15 = 3 (0x0003)
+; CHECK: calls: 1 (0 runtime)
@@ -0,0 +1,44 @@
+; Walk a statically linked list: pointer chasing through data relocations.
+; RUN: llc -mtriple=tnt -filetype=obj %s -o %t.o
+; RUN: tnt-sim -max-cycles=300 %t.o | FileCheck %s
+
+target datalayout = "e-m:e-p:16:16-i32:16:32-a:16-n8:16"
+target triple = "tnt"
+
+%node = type { i16, %node* }
+
+@n5 = global %node { i16 500, %node* null }
+@n4 = global %node { i16 -40, %node* @n5 }
+@n3 = global %node { i16 3000, %node* @n4 }
+@n2 = global %node { i16 20, %node* @n3 }
+@n1 = global %node { i16 1, %node* @n2 }
+
+define i16 @sum(%node* %n) {
+entry:
+  %z = icmp eq %node* %n, null
+  br i1 %z, label %exit, label %loop
+
+loop:
+  %p = phi %node* [ %n, %entry ], [ %next, %loop ]
+  %s = phi i16 [ 0, %entry ], [ %s.next, %loop ]
+  %pv = getelementptr %node, %node* %p, i16 0, i32 0
+  %v = load i16, i16* %pv
+  %s.next = add i16 %s, %v
+  %pn = getelementptr %node, %node* %p, i16 0, i32 1
+  %next = load %node*, %node** %pn
+  %d = icmp eq %node* %next, null
+  br i1 %d, label %exit, label %loop
+
+exit:
+  %r = phi i16 [ 0, %entry ], [ %s.next, %loop ]
+  ret i16 %r
+}
+
+define i16 @main() {
+  %r = call i16 @sum(%node* @n1)
+  ret i16 %r
+}
+
+; CHECK: result: r15 = 3481 (0x0d99)
+; Two loads per node plus the two return addresses.
+; CHECK: reads: 12 (24 bytes)
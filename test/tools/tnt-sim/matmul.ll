@@ -0,0 +1,91 @@
+; 4x4 matrix multiply. Without the hardware multiplier every product is a
+; runtime call; with it the products go through the memory-mapped unit.
+; RUN: llc -mtriple=tnt -filetype=obj %s -o %t.o
+; RUN: tnt-sim -max-cycles=5000 %t.o | FileCheck -check-prefix=SOFT %s
+; RUN: llc -mtriple=tnt -mattr=+hwmult -filetype=obj %s -o %t.hw.o
+; RUN: tnt-sim -max-cycles=3000 %t.hw.o | FileCheck -check-prefix=HW %s
+
+target datalayout = "e-m:e-p:16:16-i32:16:32-a:16-n8:16"
+target triple = "tnt"
+
+@a = global [16 x i16] [i16 1, i16 2, i16 3, i16 4, i16 5, i16 6, i16 7, i16 8,
+                        i16 9, i16 10, i16 11, i16 12, i16 13, i16 14, i16 15, i16 16]
+@b = global [16 x i16] [i16 -1, i16 2, i16 -3, i16 4, i16 5, i16 -6, i16 7, i16 -8,
+                        i16 9, i16 10, i16 -11, i16 12, i16 -13, i16 14, i16 15, i16 16]
+@c = common global [16 x i16] zeroinitializer
+
+define void @matmul(i16* %a, i16* %b, i16* %c) {
+entry:
+  br label %row
+
+row:
+  %i = phi i16 [ 0, %entry ], [ %i.next, %row.done ]
+  br label %col
+
+col:
+  %j = phi i16 [ 0, %row ], [ %j.next, %col.done ]
+  br label %dot
+
+dot:
+  %k = phi i16 [ 0, %col ], [ %k.next, %dot ]
+  %sum = phi i16 [ 0, %col ], [ %sum.next, %dot ]
+  %i4 = shl i16 %i, 2
+  %ai = add i16 %i4, %k
+  %pa = getelementptr i16, i16* %a, i16 %ai
+  %va = load i16, i16* %pa
+  %k4 = shl i16 %k, 2
+  %bi = add i16 %k4, %j
+  %pb = getelementptr i16, i16* %b, i16 %bi
+  %vb = load i16, i16* %pb
+  %m = mul i16 %va, %vb
+  %sum.next = add i16 %sum, %m
+  %k.next = add i16 %k, 1
+  %kd = icmp eq i16 %k.next, 4
+  br i1 %kd, label %col.done, label %dot
+
+col.done:
+  %ci = add i16 %i4, %j
+  %pc = getelementptr i16, i16* %c, i16 %ci
+  store i16 %sum.next, i16* %pc
+  %j.next = add i16 %j, 1
+  %jd = icmp eq i16 %j.next, 4
+  br i1 %jd, label %row.done, label %col
+
+row.done:
+  %i.next = add i16 %i, 1
+  %id = icmp eq i16 %i.next, 4
+  br i1 %id, label %exit, label %row
+
+exit:
+  ret void
+}
+
+; Returns a checksum of the product: sum of c[n] * (n + 1).
+define i16 @main() {
+entry:
+  call void @matmul(i16* getelementptr ([16 x i16], [16 x i16]* @a, i16 0, i16 0),
+                    i16* getelementptr ([16 x i16], [16 x i16]* @b, i16 0, i16 0),
+                    i16* getelementptr ([16 x i16], [16 x i16]* @c, i16 0, i16 0))
+  br label %loop
+
+loop:
+  %n = phi i16 [ 0, %entry ], [ %n.next, %loop ]
+  %s = phi i16 [ 0, %entry ], [ %s.next, %loop ]
+  %p = getelementptr [16 x i16], [16 x i16]* @c, i16 0, i16 %n
+  %v = load i16, i16* %p
+  %n.next = add i16 %n, 1
+  %w = mul i16 %v, %n.next
+  %s.next = add i16 %s, %w
+  %d = icmp eq i16 %n.next, 16
+  br i1 %d, label %exit, label %loop
+
+exit:
+  ret i16 %s.next
+}
+
+; SOFT: result: r15 = 22360
+; SOFT: calls: {{[0-9]+}} (80 runtime)
+; SOFT: __mulhi3
+
+; HW: result: r15 = 22360
+; HW: calls: 1 (0 runtime)
@@ -0,0 +1,1144 @@
+//===-- tnt-sim.cpp - Cycle-counting simulator for TNT objects ------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This program loads one or more TNT ELF objects produced by llc, links them
+// into a flat 64K memory, calls a function and reports how much work it did:
+// instructions executed, estimated cycles, memory traffic and a per-function
+// profile.
+//
+// Instructions are decoded with the TNT MC disassembler; the cycle cost of
+// each one comes from the scheduling model of the selected CPU. Execution
+// itself follows the instruction encoding, which TNT shares with MSP430.
+//
+// Calls to runtime library routines that are not defined by the inputs
+// (multiplication, division, shifts, memcpy, ...) are carried out by the
+// simulator with a fixed cycle estimate.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/Triple.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCDisassembler/MCDisassembler.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MC/MCInstPrinter.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCSchedule.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <map>
+
+using namespace llvm;
+using namespace object;
+
+static cl::list<std::string> InputFilenames(cl::Positional, cl::OneOrMore,
+                                            cl::desc("<input objects>"));
+
+static cl::opt<std::string> EntryName("entry", cl::init("main"),
+                                      cl::desc("Function to call"),
+                                      cl::value_desc("symbol"));
+
+static cl::list<int> Args("arg", cl::ZeroOrMore, cl::CommaSeparated,
+                          cl::desc("16-bit arguments passed in R15..R12"));
+
+static cl::opt<std::string> MCPU("mcpu", cl::init("generic"),
+                                 cl::desc("CPU whose scheduling model is used"),
+                                 cl::value_desc("cpu-name"));
+
+static cl::opt<std::string> MAttr("mattr", cl::init(""),
+                                  cl::desc("Target features"));
+
+static cl::opt<unsigned>
+    MaxCycles("max-cycles", cl::init(0),
+              cl::desc("Fail if the run takes more cycles than this"));
+
+static cl::opt<unsigned>
+    MaxInstrs("max-instrs", cl::init(100000000),
+              cl::desc("Stop after executing this many instructions"));
+
+static cl::opt<bool> Trace("trace", cl::init(false),
+                           cl::desc("Print every executed instruction"));
+
+static cl::opt<bool> NoProfile("no-profile", cl::init(false),
+                               cl::desc("Do not print the function profile"));
+
+static const char *ToolName;
+
+namespace {
+
+// Memory map. Objects are linked as on a small MSP430 part: peripherals in
+// the first 512 bytes, writable sections from 0x0200 with the stack growing
+// down from 0x4000, read-only sections from 0x4400. Runtime routines and the
+// return address of the entry function live just below the vector table.
+enum : unsigned {
+  RAMStart   = 0x0200,
+  StackTop   = 0x4000,
+  ROMStart   = 0x4400,
+  StubStart  = 0xff00,
+  StubEnd    = 0xffe0,
+  MemorySize = 0x10000
+};
+
+// Hardware multiplier registers.
+enum : unsigned {
+  HWMultMPY    = 0x0130,
+  HWMultMPYS   = 0x0132,
+  HWMultMAC    = 0x0134,
+  HWMultMACS   = 0x0136,
+  HWMultOP2    = 0x0138,
+  HWMultRESLO  = 0x013a,
+  HWMultRESHI  = 0x013c,
+  HWMultSUMEXT = 0x013e
+};
+
+enum : unsigned { PC = 0, SP = 1, SR = 2, CG = 3 };
+
+enum : uint16_t {
+  FlagC = 1 << 0,
+  FlagZ = 1 << 1,
+  FlagN = 1 << 2,
+  FlagV = 1 << 8
+};
+
+/// Runtime routines the simulator provides when no input defines them.
+enum class Runtime {
+  Exit,
+  Mul8, Mul16, Mul32,
+  SDiv8, UDiv8, SRem8, URem8,
+  SDiv16, UDiv16, SRem16, URem16,
+  SDiv32, UDiv32, SRem32, URem32,
+  Shl16, Sra16, Srl16,
+  Shl32, Sra32, Srl32,
+  Memcpy, Memmove, Memset
+};
+
+struct RuntimeEntry {
+  const char *Name;
+  Runtime Kind;
+};
+
+// Multiplication routines come in software, "hw" and "hw_noint" flavours;
+// the suffix is stripped before the lookup.
+static const RuntimeEntry RuntimeTable[] = {
+  { "__mulqi3",  Runtime::Mul8   }, { "__mulhi3",  Runtime::Mul16  },
+  { "__mulsi3",  Runtime::Mul32  },
+  { "__divqi3",  Runtime::SDiv8  }, { "__udivqi3", Runtime::UDiv8  },
+  { "__modqi3",  Runtime::SRem8  }, { "__umodqi3", Runtime::URem8  },
+  { "__divhi3",  Runtime::SDiv16 }, { "__udivhi3", Runtime::UDiv16 },
+  { "__modhi3",  Runtime::SRem16 }, { "__umodhi3", Runtime::URem16 },
+  { "__divsi3",  Runtime::SDiv32 }, { "__udivsi3", Runtime::UDiv32 },
+  { "__modsi3",  Runtime::SRem32 }, { "__umodsi3", Runtime::URem32 },
+  { "__ashlhi3", Runtime::Shl16  }, { "__ashrhi3", Runtime::Sra16  },
+  { "__lshrhi3", Runtime::Srl16  },
+  { "__ashlsi3", Runtime::Shl32  }, { "__ashrsi3", Runtime::Sra32  },
+  { "__lshrsi3", Runtime::Srl32  },
+  { "memcpy",    Runtime::Memcpy }, { "memmove",   Runtime::Memmove },
+  { "memset",    Runtime::Memset },
+};
+
+struct Stub {
+  std::string Name;
+  Runtime Kind;
+  bool HWMult;
+};
+
+struct FunctionInfo {
+  std::string Name;
+  uint16_t Start;
+  uint16_t End;
+  uint64_t Cycles = 0;
+  uint64_t Instrs = 0;
+  uint64_t Calls = 0;
+};
+
+/// Per-address decode results. Code is not expected to modify itself, but a
+/// store to a decoded address drops the entry anyway.
+struct DecodedInst {
+  bool Valid = false;
+  uint8_t Size = 0;
+  /// Cycles from the scheduling model, 0 if it has none for this opcode.
+  uint16_t Cycles = 0;
+  MCInst Inst;
+};
+
+class Simulator {
+public:
+  Simulator(const Target &T, const Triple &TT);
+
+  bool load(ArrayRef<std::string> Files);
+  bool run(StringRef Entry, ArrayRef<int> Args);
+  void report(raw_ostream &OS) const;
+
+private:
+  // Target description.
+  std::unique_ptr<const MCRegisterInfo> MRI;
+  std::unique_ptr<const MCAsmInfo> MAI;
+  std::unique_ptr<const MCSubtargetInfo> STI;
+  std::unique_ptr<const MCInstrInfo> MII;
+  std::unique_ptr<MCContext> Ctx;
+  std::unique_ptr<const MCDisassembler> DisAsm;
+  std::unique_ptr<MCInstPrinter> IP;
+
+  // Loaded program.
+  std::vector<OwningBinary<Binary>> Binaries;
+  StringMap<uint16_t> Globals;
+  std::vector<FunctionInfo> Functions;
+  std::vector<Stub> Stubs;
+
+  // Machine state.
+  uint16_t R[16] = {};
+  std::vector<uint8_t> Mem;
+  std::vector<DecodedInst> Decoded;
+  uint16_t MultOp1 = 0;
+  unsigned MultMode = HWMultMPY;
+
+  // Statistics.
+  uint64_t NumInstrs = 0;
+  uint64_t NumCycles = 0;
+  uint64_t NumFetches = 0;
+  uint64_t NumReads = 0, ReadBytes = 0;
+  uint64_t NumWrites = 0, WriteBytes = 0;
+  uint64_t NumStackAccesses = 0;
+  uint64_t NumCalls = 0, NumRuntimeCalls = 0;
+  uint16_t LowestSP = StackTop;
+  // Memory accesses of the instruction being executed, fetches included.
+  unsigned CurAccesses = 0;
+
+  bool error(const Twine &Msg) const;
+
+  // Linking.
+  bool loadObject(const ObjectFile &Obj, StringRef File,
+                  uint16_t &ROMNext, uint16_t &RAMNext,
+                  std::map<SectionRef, uint16_t> &SectionAddrs);
+  bool resolveSymbol(const SymbolRef &Sym,
+                     const std::map<SectionRef, uint16_t> &SectionAddrs,
+                     uint16_t &Value);
+  bool applyRelocations(const ObjectFile &Obj,
+                        const std::map<SectionRef, uint16_t> &SectionAddrs);
+  uint16_t getStub(StringRef Name);
+  FunctionInfo *findFunction(uint16_t Addr);
+
+  // Memory.
+  uint16_t fetch();
+  uint16_t read(uint16_t Addr, bool Byte);
+  void write(uint16_t Addr, uint16_t Value, bool Byte);
+  void push(uint16_t Value);
+  uint16_t pop();
+
+  // Execution.
+  const DecodedInst *decode(uint16_t Addr);
+  bool step();
+  bool callRuntime(const Stub &S);
+};
+
+/// An instruction operand: a register, a constant or a memory location.
+struct Operand {
+  enum { Reg, Const, Mem } Kind;
+  uint16_t Value; // Register number, constant or address.
+};
+
+} // end anonymous namespace
+
+static uint16_t read16(const std::vector<uint8_t> &Mem, uint16_t Addr) {
+  return Mem[Addr] | (Mem[uint16_t(Addr + 1)] << 8);
+}
+
+Simulator::Simulator(const Target &T, const Triple &TT)
+    : Mem(MemorySize), Decoded(MemorySize) {
+  MRI.reset(T.createMCRegInfo(TT.getTriple()));
+  MAI.reset(T.createMCAsmInfo(*MRI, TT.getTriple()));
+  STI.reset(T.createMCSubtargetInfo(TT.getTriple(), MCPU, MAttr));
+  MII.reset(T.createMCInstrInfo());
+  Ctx.reset(new MCContext(MAI.get(), MRI.get(), nullptr));
+  DisAsm.reset(T.createMCDisassembler(*STI, *Ctx));
+  IP.reset(T.createMCInstPrinter(TT, 0, *MAI, *MII, *MRI));
+  if (!DisAsm || !IP)
+    report_fatal_error("no disassembler for target " + TT.getTriple());
+
+  // The return address of the entry function.
+  Stubs.push_back({"<exit>", Runtime::Exit, false});
+}
+
+bool Simulator::error(const Twine &Msg) const {
+  errs() << ToolName << ": error: " << Msg << "\n";
+  return false;
+}
+
+//===----------------------------------------------------------------------===//
+// Linking
+//===----------------------------------------------------------------------===//
+
+bool Simulator::load(ArrayRef<std::string> Files) {
+  uint16_t ROMNext = ROMStart, RAMNext = RAMStart;
+  std::vector<std::map<SectionRef, uint16_t>> SectionAddrs(Files.size());
+
+  // Lay out all sections and collect the global symbols first, so that
+  // relocations can refer to any input.
+  for (unsigned i = 0, e = Files.size(); i != e; ++i) {
+    Expected<OwningBinary<Binary>> BinOrErr = createBinary(Files[i]);
+    if (!BinOrErr) {
+      std::string Buf;
+      raw_string_ostream OS(Buf);
+      logAllUnhandledErrors(BinOrErr.takeError(), OS, "");
+      return error(Files[i] + ": " + OS.str());
+    }
+    Binaries.push_back(std::move(*BinOrErr));
+
+    // TNT objects carry the MSP430 machine type.
+    auto *Obj = dyn_cast<ELFObjectFileBase>(Binaries.back().getBinary());
+    if (!Obj || Obj->getArch() != Triple::msp430)
+      return error(Files[i] + ": not a TNT ELF object");
+    if (!loadObject(*Obj, Files[i], ROMNext, RAMNext, SectionAddrs[i]))
+      return false;
+  }
+
+  for (unsigned i = 0, e = Files.size(); i != e; ++i) {
+    auto *Obj = cast<ObjectFile>(Binaries[i].getBinary());
+    if (!applyRelocations(*Obj, SectionAddrs[i]))
+      return false;
+  }
+
+  std::sort(Functions.begin(), Functions.end(),
+            [](const FunctionInfo &A, const FunctionInfo &B) {
+              return A.Start < B.Start;
+            });
+  return true;
+}
+
+bool Simulator::loadObject(const ObjectFile &Obj, StringRef File,
+                           uint16_t &ROMNext, uint16_t &RAMNext,
+                           std::map<SectionRef, uint16_t> &SectionAddrs) {
+  for (const SectionRef &Sec : Obj.sections()) {
+    ELFSectionRef ESec(Sec);
+    if (!(ESec.getFlags() & ELF::SHF_ALLOC) || Sec.getSize() == 0)
+      continue;
+
+    bool Writable = ESec.getFlags() & ELF::SHF_WRITE;
+    uint16_t &Next = Writable ? RAMNext : ROMNext;
+    uint64_t Align = std::max<uint64_t>(Sec.getAlignment(), 1);
+    uint64_t Addr = alignTo(Next, Align);
+    uint64_t Limit = Writable ? StackTop : StubStart;
+    if (Addr + Sec.getSize() > Limit)
+      return error(File + ": sections do not fit in memory");
+
+    if (ESec.getType() != ELF::SHT_NOBITS) {
+      StringRef Contents;
+      if (std::error_code EC = Sec.getContents(Contents))
+        return error(File + ": " + EC.message());
+      std::copy(Contents.begin(), Contents.end(), Mem.begin() + Addr);
+    }
+    SectionAddrs[Sec] = Addr;
+    Next = Addr + Sec.getSize();
+  }
+
+  for (const SymbolRef &Sym : Obj.symbols()) {
+    Expected<StringRef> NameOrErr = Sym.getName();
+    Expected<SymbolRef::Type> TypeOrErr = Sym.getType();
+    if (!NameOrErr || !TypeOrErr)
+      return error(File + ": invalid symbol");
+    uint32_t Flags = Sym.getFlags();
+    if (Flags & SymbolRef::SF_Undefined)
+      continue;
+
+    uint16_t Value;
+    if (Flags & SymbolRef::SF_Common) {
+      uint64_t Addr = alignTo(RAMNext, std::max<uint32_t>(Sym.getAlignment(), 1));
+      if (Addr + Sym.getCommonSize() > StackTop)
+        return error(File + ": common symbols do not fit in memory");
+      Value = Addr;
+      RAMNext = Addr + Sym.getCommonSize();
+    } else if (!resolveSymbol(Sym, SectionAddrs, Value)) {
+      return error(File + ": cannot resolve symbol " + *NameOrErr);
+    }
+
+    if ((Flags & SymbolRef::SF_Global) || (Flags & SymbolRef::SF_Common)) {
+      if (!Globals.insert(std::make_pair(*NameOrErr, Value)).second)
+        return error(File + ": duplicate symbol " + *NameOrErr);
+    }
+
+    if (*TypeOrErr == SymbolRef::ST_Function) {
+      FunctionInfo FI;
+      FI.Name = *NameOrErr;
+      FI.Start = Value;
+      FI.End = Value + std::max<uint64_t>(ELFSymbolRef(Sym).getSize(), 2);
+      Functions.push_back(FI);
+    }
+  }
+  return true;
+}
+
+bool Simulator::resolveSymbol(const SymbolRef &Sym,
+                              const std::map<SectionRef, uint16_t> &SectionAddrs,
+                              uint16_t &Value) {
+  if (Sym.getFlags() & SymbolRef::SF_Undefined) {
+    Expected<StringRef> NameOrErr = Sym.getName();
+    if (!NameOrErr)
+      return false;
+    auto I = Globals.find(*NameOrErr);
+    if (I != Globals.end()) {
+      Value = I->second;
+      return true;
+    }
+    Value = getStub(*NameOrErr);
+    return Value != 0;
+  }
+
+  Expected<section_iterator> SecOrErr = Sym.getSection();
+  if (!SecOrErr)
+    return false;
+  if (*SecOrErr == Sym.getObject()->section_end()) {
+    // Absolute symbol.
+    Value = Sym.getValue();
+    return true;
+  }
+  auto I = SectionAddrs.find(**SecOrErr);
+  if (I == SectionAddrs.end())
+    return false;
+  Value = I->second + Sym.getValue();
+  return true;
+}
+
+/// Return the address of the simulator-provided routine Name, or 0 if there
+/// is no such routine.
+uint16_t Simulator::getStub(StringRef Name) {
+  for (unsigned i = 0, e = Stubs.size(); i != e; ++i)
+    if (Stubs[i].Name == Name)
+      return StubStart + 2 * i;
+
+  StringRef Base = Name;
+  bool HWMult = false;
+  for (StringRef Suffix : {"hw_noint", "hw"})
+    if (Base.endswith(Suffix)) {
+      Base = Base.drop_back(Suffix.size());
+      HWMult = true;
+      break;
+    }
+  for (const RuntimeEntry &E : RuntimeTable) {
+    if (Base != E.Name)
+      continue;
+    if (StubStart + 2 * Stubs.size() >= StubEnd)
+      return 0;
+    Stubs.push_back({Name, E.Kind, HWMult});
+    FunctionInfo FI;
+    FI.Name = Name;
+    FI.Start = StubStart + 2 * (Stubs.size() - 1);
+    FI.End = FI.Start + 2;
+    Functions.push_back(FI);
+    return FI.Start;
+  }
+  return 0;
+}
+
+bool Simulator::applyRelocations(
+    const ObjectFile &Obj, const std::map<SectionRef, uint16_t> &SectionAddrs) {
+  for (const SectionRef &RelSec : Obj.sections()) {
+    section_iterator Target = RelSec.getRelocatedSection();
+    if (Target == Obj.section_end())
+      continue;
+    auto TI = SectionAddrs.find(*Target);
+    if (TI == SectionAddrs.end())
+      continue; // Not loaded, e.g. debug info.
+
+    for (const RelocationRef &Rel : RelSec.relocations()) {
+      uint16_t P = TI->second + Rel.getOffset();
+      uint16_t S = 0;
+      symbol_iterator Sym = Rel.getSymbol();
+      if (Sym != Obj.symbol_end() && !resolveSymbol(*Sym, SectionAddrs, S)) {
+        Expected<StringRef> NameOrErr = Sym->getName();
+        return error("undefined symbol " +
+                     (NameOrErr ? *NameOrErr : StringRef("<unknown>")));
+      }
+      ErrorOr<int64_t> AddendOrErr = ELFRelocationRef(Rel).getAddend();
+      int64_t A = AddendOrErr ? *AddendOrErr : 0;
+      uint16_t V = S + A;
+
+      switch (Rel.getType()) {
+      case ELF::R_MSP430_8:
+        Mem[P] = V;
+        break;
+      case ELF::R_MSP430_16:
+      case ELF::R_MSP430_16_BYTE:
+        Mem[P] = V;
+        Mem[uint16_t(P + 1)] = V >> 8;
+        break;
+      case ELF::R_MSP430_32:
+        Mem[P] = V;
+        Mem[uint16_t(P + 1)] = V >> 8;
+        Mem[uint16_t(P + 2)] = 0;
+        Mem[uint16_t(P + 3)] = 0;
+        break;
+      case ELF::R_MSP430_16_PCREL:
+      case ELF::R_MSP430_16_PCREL_BYTE: {
+        uint16_t D = V - P;
+        Mem[P] = D;
+        Mem[uint16_t(P + 1)] = D >> 8;
+        break;
+      }
+      case ELF::R_MSP430_10_PCREL: {
+        // Word offset from the word following the jump.
+        int Offset = (int16_t(V - P) >> 1) - 1;
+        if (Offset < -512 || Offset > 511)
+          return error("jump relocation out of range");
+        uint16_t Word = (read16(Mem, P) & ~0x3ff) | (Offset & 0x3ff);
+        Mem[P] = Word;
+        Mem[uint16_t(P + 1)] = Word >> 8;
+        break;
+      }
+      default:
+        return error("unsupported relocation type " + Twine(Rel.getType()));
+      }
+    }
+  }
+  return true;
+}
+
+FunctionInfo *Simulator::findFunction(uint16_t Addr) {
+  auto I = std::upper_bound(Functions.begin(), Functions.end(), Addr,
+                            [](uint16_t A, const FunctionInfo &F) {
+                              return A < F.Start;
+                            });
+  if (I == Functions.begin())
+    return nullptr;
+  --I;
+  return Addr < I->End ? &*I : nullptr;
+}
+
+//===----------------------------------------------------------------------===//
+// Memory
+//===----------------------------------------------------------------------===//
+
+uint16_t Simulator::fetch() {
+  uint16_t Value = read16(Mem, R[PC]);
+  R[PC] += 2;
+  ++NumFetches;
+  ++CurAccesses;
+  return Value;
+}
+
+uint16_t Simulator::read(uint16_t Addr, bool Byte) {
+  ++NumReads;
+  ++CurAccesses;
+  ReadBytes += Byte ? 1 : 2;
+  if (Addr >= LowestSP - 2 && Addr < StackTop)
+    ++NumStackAccesses;
+  if (Byte)
+    return Mem[Addr];
+  return read16(Mem, Addr & ~1);
+}
+
+void Simulator::write(uint16_t Addr, uint16_t Value, bool Byte) {
+  ++NumWrites;
+  ++CurAccesses;
+  WriteBytes += Byte ? 1 : 2;
+  if (Addr >= LowestSP - 2 && Addr < StackTop)
+    ++NumStackAccesses;
+  if (!Byte)
+    Addr &= ~1;
+
+  Mem[Addr] = Value;
+  if (!Byte)
+    Mem[Addr + 1] = Value >> 8;
+  for (unsigned i = 0; i != 6 && i <= Addr; ++i)
+    Decoded[Addr - i].Valid = false;
+
+  switch (Addr & ~1) {
+  case HWMultMPY:
+  case HWMultMPYS:
+  case HWMultMAC:
+  case HWMultMACS:
+    MultMode = Addr & ~1;
+    MultOp1 = read16(Mem, Addr & ~1);
+    break;
+  case HWMultOP2: {
+    uint16_t Op2 = read16(Mem, HWMultOP2);
+    bool Signed = MultMode == HWMultMPYS || MultMode == HWMultMACS;
+    uint32_t Res = Signed ? uint32_t(int32_t(int16_t(MultOp1)) * int16_t(Op2))
+                          : uint32_t(MultOp1) * Op2;
+    uint16_t SumExt = Signed ? (Res & 0x80000000 ? 0xffff : 0) : 0;
+    if (MultMode == HWMultMAC || MultMode == HWMultMACS) {
+      uint32_t Acc = read16(Mem, HWMultRESLO) |
+                     (uint32_t(read16(Mem, HWMultRESHI)) << 16);
+      uint64_t Sum = uint64_t(Acc) + Res;
+      SumExt = MultMode == HWMultMAC ? (Sum >> 32) & 1 : SumExt;
+      Res = Sum;
+    }
+    auto Set = [&](unsigned A, uint16_t V) {
+      Mem[A] = V;
+      Mem[A + 1] = V >> 8;
+    };
+    Set(HWMultRESLO, Res);
+    Set(HWMultRESHI, Res >> 16);
+    Set(HWMultSUMEXT, SumExt);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+void Simulator::push(uint16_t Value) {
+  R[SP] -= 2;
+  LowestSP = std::min(LowestSP, R[SP]);
+  write(R[SP], Value, false);
+}
+
+uint16_t Simulator::pop() {
+  uint16_t Value = read(R[SP], false);
+  R[SP] += 2;
+  return Value;
+}
+
+//===----------------------------------------------------------------------===//
+// Execution
+//===----------------------------------------------------------------------===//
+
+const DecodedInst *Simulator::decode(uint16_t Addr) {
+  DecodedInst &D = Decoded[Addr];
+  if (D.Valid)
+    return &D;
+
+  uint64_t Size;
+  ArrayRef<uint8_t> Bytes(Mem.data() + Addr,
+                          std::min<size_t>(6, MemorySize - Addr));
+  D.Inst = MCInst();
+  if (DisAsm->getInstruction(D.Inst, Size, Bytes, Addr, nulls(), nulls()) !=
+      MCDisassembler::Success)
+    return nullptr;
+  D.Size = Size;
+
+  D.Cycles = 0;
+  const MCSchedModel &SM = STI->getSchedModel();
+  if (SM.hasInstrSchedModel()) {
+    unsigned SchedClass = MII->get(D.Inst.getOpcode()).getSchedClass();
+    const MCSchedClassDesc *SC = SM.getSchedClassDesc(SchedClass);
+    if (SC && SC->isValid() && !SC->isVariant())
+      for (unsigned i = 0, e = SC->NumWriteLatencyEntries; i != e; ++i)
+        D.Cycles = std::max<uint16_t>(
+            D.Cycles, STI->getWriteLatencyEntry(SC, i)->Cycles);
+  }
+  D.Valid = true;
+  return &D;
+}
+
+static bool isNegative(uint16_t V, bool Byte) {
+  return V & (Byte ? 0x80 : 0x8000);
+}
+
+static uint16_t setFlags(uint16_t SRValue, uint16_t Res, bool Byte, bool C,
+                         bool V) {
+  SRValue &= ~(FlagC | FlagZ | FlagN | FlagV);
+  if (C)
+    SRValue |= FlagC;
+  if (Res == 0)
+    SRValue |= FlagZ;
+  if (isNegative(Res, Byte))
+    SRValue |= FlagN;
+  if (V)
+    SRValue |= FlagV;
+  return SRValue;
+}
+
+bool Simulator::step() {
+  uint16_t Addr = R[PC];
+
+  if (Addr >= StubStart && Addr < StubEnd && (Addr & 1) == 0 &&
+      (Addr - StubStart) / 2 < Stubs.size()) {
+    const Stub &S = Stubs[(Addr - StubStart) / 2];
+    if (S.Kind == Runtime::Exit)
+      return false;
+    return callRuntime(S);
+  }
+
+  const DecodedInst *D = decode(Addr);
+  if (!D)
+    return error("invalid instruction at " + Twine::utohexstr(Addr));
+  if (Trace) {
+    outs() << format("%04x: ", Addr);
+    IP->printInst(&D->Inst, outs(), "", *STI);
+    outs() << "\n";
+  }
+
+  CurAccesses = 0;
+  uint16_t Op = fetch();
+  unsigned Hi = Op >> 12;
+  bool Byte = Op & 0x40;
+  uint16_t Mask = Byte ? 0xff : 0xffff;
+
+  // Decode the source (or single) operand given its register and mode.
+  auto DecodeSrc = [&](unsigned Reg, unsigned As) -> Operand {
+    if (Reg == CG) {
+      static const uint16_t CGValues[] = { 0, 1, 2, 0xffff };
+      return {Operand::Const, uint16_t(CGValues[As] & Mask)};
+    }
+    if (Reg == SR && As >= 2)
+      return {Operand::Const, uint16_t(As == 2 ? 4 : 8)};
+    switch (As) {
+    case 0:
+      return {Operand::Reg, uint16_t(Reg)};
+    case 1: {
+      uint16_t X = fetch();
+      if (Reg == SR)
+        return {Operand::Mem, X};
+      if (Reg == PC)
+        return {Operand::Mem, uint16_t(R[PC] - 2 + X)};
+      return {Operand::Mem, uint16_t(R[Reg] + X)};
+    }
+    case 2:
+      return {Operand::Mem, R[Reg]};
+    default:
+      if (Reg == PC)
+        return {Operand::Const, uint16_t(fetch() & Mask)};
+      uint16_t A = R[Reg];
+      R[Reg] += (Byte && Reg != SP) ? 1 : 2;
+      return {Operand::Mem, A};
+    }
+  };
+  auto DecodeDst = [&](unsigned Reg, unsigned Ad) -> Operand {
+    if (!Ad)
+      return {Operand::Reg, uint16_t(Reg)};
+    uint16_t X = fetch();
+    if (Reg == SR)
+      return {Operand::Mem, X};
+    if (Reg == PC)
+      return {Operand::Mem, uint16_t(R[PC] - 2 + X)};
+    return {Operand::Mem, uint16_t(R[Reg] + X)};
+  };
+  auto Read = [&](const Operand &O) -> uint16_t {
+    switch (O.Kind) {
+    case Operand::Reg:   return R[O.Value] & Mask;
+    case Operand::Const: return O.Value;
+    case Operand::Mem:   return read(O.Value, Byte);
+    }
+    llvm_unreachable("bad operand kind");
+  };
+  auto Write = [&](const Operand &O, uint16_t V) {
+    V &= Mask;
+    if (O.Kind == Operand::Mem) {
+      write(O.Value, V, Byte);
+    } else if (O.Kind == Operand::Reg && O.Value != CG) {
+      R[O.Value] = O.Value == PC ? V & ~1 : V;
+      if (O.Value == SP)
+        LowestSP = std::min(LowestSP, R[SP]);
+    }
+  };
+  auto Carry = [&]() -> unsigned { return R[SR] & FlagC ? 1 : 0; };
+  auto Add = [&](uint16_t A, uint16_t B, unsigned C, uint16_t &Res) {
+    uint32_t Sum = uint32_t(A) + B + C;
+    Res = Sum & Mask;
+    bool V = isNegative(~(A ^ B) & (A ^ Res), Byte);
+    R[SR] = setFlags(R[SR], Res, Byte, Sum > Mask, V);
+  };
+
+  if (Hi >= 4) {
+    // Format I: double operand.
+    Operand Src = DecodeSrc((Op >> 8) & 0xf, (Op >> 4) & 3);
+    Operand Dst = DecodeDst(Op & 0xf, (Op >> 7) & 1);
+    uint16_t S = Read(Src);
+    uint16_t Res;
+    switch (Hi) {
+    case 0x4: // mov
+      Write(Dst, S);
+      break;
+    case 0x5: // add
+      Add(Read(Dst), S, 0, Res);
+      Write(Dst, Res);
+      break;
+    case 0x6: // addc
+      Add(Read(Dst), S, Carry(), Res);
+      Write(Dst, Res);
+      break;
+    case 0x7: // subc
+      Add(Read(Dst), ~S & Mask, Carry(), Res);
+      Write(Dst, Res);
+      break;
+    case 0x8: // sub
+      Add(Read(Dst), ~S & Mask, 1, Res);
+      Write(Dst, Res);
+      break;
+    case 0x9: // cmp
+      Add(Read(Dst), ~S & Mask, 1, Res);
+      break;
+    case 0xa: { // dadd
+      uint16_t DV = Read(Dst);
+      unsigned C = Carry();
+      Res = 0;
+      for (unsigned Shift = 0; Shift != (Byte ? 8u : 16u); Shift += 4) {
+        unsigned Digit = ((DV >> Shift) & 0xf) + ((S >> Shift) & 0xf) + C;
+        C = Digit > 9;
+        if (C)
+          Digit -= 10;
+        Res |= (Digit & 0xf) << Shift;
+      }
+      R[SR] = setFlags(R[SR], Res, Byte, C, false);
+      Write(Dst, Res);
+      break;
+    }
+    case 0xb: // bit
+      Res = Read(Dst) & S;
+      R[SR] = setFlags(R[SR], Res, Byte, Res != 0, false);
+      break;
+    case 0xc: // bic
+      Write(Dst, Read(Dst) & ~S);
+      break;
+    case 0xd: // bis
+      Write(Dst, Read(Dst) | S);
+      break;
+    case 0xe: { // xor
+      uint16_t DV = Read(Dst);
+      Res = DV ^ S;
+      R[SR] = setFlags(R[SR], Res, Byte, Res != 0,
+                       isNegative(DV, Byte) && isNegative(S, Byte));
+      Write(Dst, Res);
+      break;
+    }
+    case 0xf: // and
+      Res = Read(Dst) & S;
+      R[SR] = setFlags(R[SR], Res, Byte, Res != 0, false);
+      Write(Dst, Res);
+      break;
+    }
+  } else if (Hi >= 2) {
+    // Conditional and unconditional jumps.
+    int Offset = SignExtend32<10>(Op & 0x3ff);
+    bool N = R[SR] & FlagN, Z = R[SR] & FlagZ;
+    bool C = R[SR] & FlagC, V = R[SR] & FlagV;
+    bool Taken;
+    switch ((Op >> 10) & 7) {
+    case 0: Taken = !Z;        break; // jne
+    case 1: Taken = Z;         break; // jeq
+    case 2: Taken = !C;        break; // jlo
+    case 3: Taken = C;         break; // jhs
+    case 4: Taken = N;         break; // jn
+    case 5: Taken = N == V;    break; // jge
+    case 6: Taken = N != V;    break; // jl
+    default: Taken = true;     break; // jmp
+    }
+    if (Taken)
+      R[PC] += Offset * 2;
+  } else if ((Op & 0xfc00) == 0x1000) {
+    // Format II: single operand.
+    unsigned Opc = (Op >> 7) & 7;
+    Operand Src = DecodeSrc(Op & 0xf, (Op >> 4) & 3);
+    switch (Opc) {
+    case 0: { // rrc
+      uint16_t V = Read(Src);
+      uint16_t Res = (V >> 1) | (Carry() ? (Byte ? 0x80 : 0x8000) : 0);
+      R[SR] = setFlags(R[SR], Res, Byte, V & 1, false);
+      Write(Src, Res);
+      break;
+    }
+    case 1: { // swpb
+      Byte = false;
+      Mask = 0xffff;
+      uint16_t V = Read(Src);
+      Write(Src, uint16_t((V >> 8) | (V << 8)));
+      break;
+    }
+    case 2: { // rra
+      uint16_t V = Read(Src);
+      uint16_t Res = (V >> 1) | (V & (Byte ? 0x80 : 0x8000));
+      R[SR] = setFlags(R[SR], Res, Byte, V & 1, false);
+      Write(Src, Res);
+      break;
+    }
+    case 3: { // sxt
+      Byte = false;
+      Mask = 0xffff;
+      uint16_t Res = int16_t(int8_t(Read(Src) & 0xff));
+      R[SR] = setFlags(R[SR], Res, false, Res != 0, false);
+      Write(Src, Res);
+      break;
+    }
+    case 4: { // push
+      uint16_t V = Read(Src);
+      push(V);
+      break;
+    }
+    case 5: { // call
+      Byte = false;
+      Mask = 0xffff;
+      uint16_t Target = Read(Src);
+      push(R[PC]);
+      R[PC] = Target & ~1;
+      ++NumCalls;
+      if (FunctionInfo *FI = findFunction(R[PC]))
+        if (FI->Start == R[PC])
+          ++FI->Calls;
+      break;
+    }
+    case 6: // reti
+      R[SR] = pop();
+      R[PC] = pop();
+      break;
+    default:
+      return error("invalid instruction at " + Twine::utohexstr(Addr));
+    }
+  } else {
+    return error("invalid instruction at " + Twine::utohexstr(Addr));
+  }
+
+  // Without a model entry, charge one cycle per memory access.
+  unsigned Cycles = D->Cycles ? D->Cycles : CurAccesses;
+  ++NumInstrs;
+  NumCycles += Cycles;
+  if (FunctionInfo *FI = findFunction(Addr)) {
+    ++FI->Instrs;
+    FI->Cycles += Cycles;
+  }
+  return true;
+}
+
+/// Carry out a runtime library call. Arguments and results follow the TNT
+/// calling convention: i16 values in R15, R14, ...; i32 values in register
+/// pairs, low word first (R14:R15, then R12:R13).
+bool Simulator::callRuntime(const Stub &S) {
+  auto Arg32 = [&](unsigned Lo) -> uint32_t {
+    return R[Lo] | (uint32_t(R[Lo + 1]) << 16);
+  };
+  auto Ret32 = [&](uint32_t V) {
+    R[14] = V;
+    R[15] = V >> 16;
+  };
+  auto DivZero = [&]() {
+    return error("division by zero in " + S.Name);
+  };
+
+  uint16_t A = R[15], B = R[14];
+  unsigned Cycles;
+  switch (S.Kind) {
+  case Runtime::Exit:
+    llvm_unreachable("exit is not a call");
+  case Runtime::Mul8:
+    R[15] = uint8_t(A * B);
+    Cycles = S.HWMult ? 16 : 60;
+    break;
+  case Runtime::Mul16:
+    R[15] = A * B;
+    Cycles = S.HWMult ? 20 : 150;
+    break;
+  case Runtime::Mul32:
+    Ret32(Arg32(14) * Arg32(12));
+    Cycles = S.HWMult ? 60 : 450;
+    break;
+  case Runtime::SDiv8:
+  case Runtime::UDiv8:
+  case Runtime::SRem8:
+  case Runtime::URem8: {
+    if (!uint8_t(B))
+      return DivZero();
+    int SA = int8_t(A), SB = int8_t(B);
+    unsigned UA = uint8_t(A), UB = uint8_t(B);
+    switch (S.Kind) {
+    case Runtime::SDiv8: R[15] = uint8_t(SA / SB); break;
+    case Runtime::UDiv8: R[15] = UA / UB;          break;
+    case Runtime::SRem8: R[15] = uint8_t(SA % SB); break;
+    default:             R[15] = UA % UB;          break;
+    }
+    Cycles = 120;
+    break;
+  }
+  case Runtime::SDiv16:
+  case Runtime::UDiv16:
+  case Runtime::SRem16:
+  case Runtime::URem16:
+    if (!B)
+      return DivZero();
+    switch (S.Kind) {
+    case Runtime::SDiv16: R[15] = int16_t(A) / int16_t(B); break;
+    case Runtime::UDiv16: R[15] = A / B;                   break;
+    case Runtime::SRem16: R[15] = int16_t(A) % int16_t(B); break;
+    default:              R[15] = A % B;                   break;
+    }
+    Cycles = 250;
+    break;
+  case Runtime::SDiv32:
+  case Runtime::UDiv32:
+  case Runtime::SRem32:
+  case Runtime::URem32: {
+    uint32_t UA = Arg32(14), UB = Arg32(12);
+    if (!UB)
+      return DivZero();
+    int32_t SA = UA, SB = UB;
+    switch (S.Kind) {
+    case Runtime::SDiv32: Ret32(SA / SB); break;
+    case Runtime::UDiv32: Ret32(UA / UB); break;
+    case Runtime::SRem32: Ret32(SA % SB); break;
+    default:              Ret32(UA % UB); break;
+    }
+    Cycles = 700;
+    break;
+  }
+  case Runtime::Shl16:
+  case Runtime::Sra16:
+  case Runtime::Srl16: {
+    unsigned Amt = B & 15;
+    if (S.Kind == Runtime::Shl16)
+      R[15] = A << Amt;
+    else if (S.Kind == Runtime::Sra16)
+      R[15] = int16_t(A) >> Amt;
+    else
+      R[15] = A >> Amt;
+    Cycles = 10 + 4 * Amt;
+    break;
+  }
+  case Runtime::Shl32:
+  case Runtime::Sra32:
+  case Runtime::Srl32: {
+    uint32_t V = Arg32(14);
+    unsigned Amt = R[13] & 31;
+    if (S.Kind == Runtime::Shl32)
+      Ret32(V << Amt);
+    else if (S.Kind == Runtime::Sra32)
+      Ret32(int32_t(V) >> Amt);
+    else
+      Ret32(V >> Amt);
+    Cycles = 10 + 8 * Amt;
+    break;
+  }
+  case Runtime::Memcpy:
+  case Runtime::Memmove: {
+    uint16_t Dst = R[15], Src = R[14], N = R[13];
+    std::vector<uint8_t> Tmp(N);
+    for (unsigned i = 0; i != N; ++i)
+      Tmp[i] = read(Src + i, true);
+    for (unsigned i = 0; i != N; ++i)
+      write(Dst + i, Tmp[i], true);
+    Cycles = 10 + 6 * N;
+    break;
+  }
+  case Runtime::Memset: {
+    uint16_t Dst = R[15], N = R[13];
+    for (unsigned i = 0; i != N; ++i)
+      write(Dst + i, R[14], true);
+    Cycles = 10 + 4 * N;
+    break;
+  }
+  }
+
+  // Return to the caller; the call itself was charged to it.
+  R[PC] = pop();
+  ++NumRuntimeCalls;
+  NumCycles += Cycles;
+  if (FunctionInfo *FI = findFunction(StubStart + 2 * (&S - Stubs.data()))) {
+    ++FI->Instrs;
+    FI->Cycles += Cycles;
+  }
+  return true;
+}
+
+bool Simulator::run(StringRef Entry, ArrayRef<int> Args) {
+  auto I = Globals.find(Entry);
+  if (I == Globals.end())
+    return error("entry function '" + Entry + "' not found");
+  if (Args.size() > 4)
+    return error("at most four arguments are supported");
+
+  for (unsigned i = 0, e = Args.size(); i != e; ++i)
+    R[15 - i] = Args[i];
+  R[SP] = StackTop;
+  push(StubStart); // Return to <exit>.
+  R[PC] = I->second;
+  if (FunctionInfo *FI = findFunction(R[PC]))
+    ++FI->Calls;
+
+  // Don't count the setup above.
+  NumWrites = WriteBytes = NumStackAccesses = 0;
+
+  while (step()) {
+    if (NumInstrs >= MaxInstrs)
+      return error("instruction limit of " + Twine(MaxInstrs) + " reached");
+    if (MaxCycles && NumCycles > MaxCycles)
+      return error("cycle limit of " + Twine(MaxCycles) + " exceeded");
+  }
+  return R[PC] >= StubStart && R[PC] < StubEnd;
+}
+
+//===----------------------------------------------------------------------===//
+// Reporting
+//===----------------------------------------------------------------------===//
+
+void Simulator::report(raw_ostream &OS) const {
+  OS << "result: r15 = " << R[15] << format(" (0x%04x)", R[15])
+     << ", r14 = " << R[14] << format(" (0x%04x)", R[14]) << "\n";
+  OS << "instructions: " << NumInstrs << "\n";
+  OS << "cycles: " << NumCycles << "\n";
+  OS << "calls: " << NumCalls << " (" << NumRuntimeCalls << " runtime)\n";
+  OS << "fetches: " << NumFetches << " words\n";
+  OS << "reads: " << NumReads << " (" << ReadBytes << " bytes)\n";
+  OS << "writes: " << NumWrites << " (" << WriteBytes << " bytes)\n";
+  OS << "stack accesses: " << NumStackAccesses << "\n";
+  OS << "stack depth: " << (StackTop - LowestSP) << " bytes\n";
+
+  if (NoProfile)
+    return;
+
+  std::vector<const FunctionInfo *> Sorted;
+  uint64_t Max = 0;
+  for (const FunctionInfo &FI : Functions)
+    if (FI.Instrs) {
+      Sorted.push_back(&FI);
+      Max = std::max(Max, FI.Cycles);
+    }
+  std::stable_sort(Sorted.begin(), Sorted.end(),
+                   [](const FunctionInfo *A, const FunctionInfo *B) {
+                     return A->Cycles > B->Cycles;
+                   });
+
+  OS << "\nprofile:\n";
+  OS << "    cycles      %    calls     instrs  function\n";
+  for (const FunctionInfo *FI : Sorted) {
+    double Percent = NumCycles ? 100.0 * FI->Cycles / NumCycles : 0.0;
+    OS << format("%10llu %5.1f%% %8llu %10llu  %-24s ",
+                 (unsigned long long)FI->Cycles, Percent,
+                 (unsigned long long)FI->Calls,
+                 (unsigned long long)FI->Instrs, FI->Name.c_str());
+    OS << std::string(Max ? 30 * FI->Cycles / Max : 0, '#') << "\n";
+  }
+}
+
+int main(int argc, char **argv) {
+  sys::PrintStackTraceOnErrorSignal(argv[0]);
+  PrettyStackTraceProgram X(argc, argv);
+  llvm_shutdown_obj Y;
+
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllDisassemblers();
+
+  cl::ParseCommandLineOptions(argc, argv, "TNT cycle-counting simulator\n");
+  ToolName = argv[0];
+
+  Triple TT("tnt");
+  std::string Err;
+  const Target *T = TargetRegistry::lookupTarget("", TT, Err);
+  if (!T) {
+    errs() << ToolName << ": error: " << Err << "\n";
+    return 1;
+  }
+
+  Simulator Sim(*T, TT);
+  if (!Sim.load(InputFilenames))
+    return 1;
+  bool Ok = Sim.run(EntryName, Args);
+  Sim.report(outs());
+  return Ok ? 0 : 1;
+}